@@ -0,0 +1,223 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (построение файла сетки ожидаемых дальностей для rfpos_grid_open())
+ * Version: 0.1b
+ * File: "rfpos_mkgrid.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+//----------------------------------------------------------------------------
+#include <stdio.h>  // fopen(), fgets(), fprintf()
+#include <stdlib.h> // strtol(), strtod(), qsort(), malloc()
+#include <unistd.h> // getopt()
+#include "rfpos_grid.h" // rfpos_grid_build()
+//----------------------------------------------------------------------------
+#define MKGRID_BUF 4096 // максимальная длина строки файла расположения
+//----------------------------------------------------------------------------
+// приёмник из файла расположения
+typedef struct {
+  long id;                // номер приёмника
+  double s[RFPOS_D_MAX];  // координаты приёмника [м]
+} mkgrid_rx_t;
+//----------------------------------------------------------------------------
+// пропустить разделители полей (пробелы, табуляции, запятые, точки с запятой)
+static char *skip_sep(char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';')
+    p++;
+  return p;
+}
+//----------------------------------------------------------------------------
+// сравнение приёмников по номеру (для qsort())
+static int rx_cmp(const void *a, const void *b)
+{
+  long ia = ((const mkgrid_rx_t*) a)->id;
+  long ib = ((const mkgrid_rx_t*) b)->id;
+  return ia < ib ? -1 : ia > ib;
+}
+//----------------------------------------------------------------------------
+// загрузить файл расположения приёмников: строки "id x y [z]"; приёмники
+// упорядочиваются по номеру (как в "rfpos_stream")
+// (возвращается число приёмников или отрицательный код ошибки)
+static int rx_load(const char *fname, int d, mkgrid_rx_t **rx)
+{
+  FILE *f;
+  char buf[MKGRID_BUF], *p, *e;
+  int i, j, n = 0, cap = 64, line = 0;
+
+  f = fopen(fname, "r");
+  if (!f)
+  {
+    fprintf(stderr, "error: can't open layout file '%s'\n", fname);
+    return -1;
+  }
+
+  *rx = (mkgrid_rx_t*) malloc(sizeof(mkgrid_rx_t) * cap);
+
+  while (*rx && fgets(buf, sizeof(buf), f))
+  {
+    mkgrid_rx_t r;
+    line++;
+
+    p = skip_sep(buf);
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+      continue; // комментарий или пустая строка
+
+    r.id = strtol(p, &e, 10);
+    for (j = 0; j < d && e != p; j++)
+    {
+      p = skip_sep(e);
+      r.s[j] = strtod(p, &e);
+    }
+    if (e == p)
+    {
+      fprintf(stderr, "error: bad line %i in layout file '%s'\n", line, fname);
+      fclose(f);
+      return -2;
+    }
+
+    if (n == cap)
+    {
+      cap *= 2;
+      *rx = (mkgrid_rx_t*) realloc(*rx, sizeof(mkgrid_rx_t) * cap);
+      if (!*rx) break;
+    }
+    (*rx)[n++] = r;
+  }
+  fclose(f);
+
+  if (!*rx)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return -3;
+  }
+  if (n < 2)
+  {
+    fprintf(stderr, "error: layout file '%s' has %i receivers\n", fname, n);
+    return -4;
+  }
+
+  qsort(*rx, n, sizeof(mkgrid_rx_t), rx_cmp);
+  for (i = 1; i < n; i++)
+    if ((*rx)[i].id == (*rx)[i - 1].id)
+    {
+      fprintf(stderr, "error: duplicate receiver id %li in '%s'\n",
+              (*rx)[i].id, fname);
+      return -5;
+    }
+
+  return n;
+}
+//----------------------------------------------------------------------------
+static void usage()
+{
+  fprintf(stderr,
+    "Usage: rfpos_mkgrid [options] -l LAYOUT -o GRID\n"
+    "Precompute expected receiver ranges over a grid of the site volume\n"
+    "for cold-start initialization (rfpos_grid_open(), rfpos_stream -g).\n"
+    "\n"
+    "  -l FILE  receiver layout: lines \"id x y [z]\" (meters)\n"
+    "  -o FILE  output grid file\n"
+    "  -d D     dimension 2 or 3 (default 3)\n"
+    "  -s STEP  grid step [m] (default 1)\n"
+    "  -m M     margin around the receivers' bounding box [m] (default 10)\n"
+    "  -b LIST  explicit volume \"x0,y0[,z0],x1,y1[,z1]\" (overrides -m)\n"
+    "\n"
+    "The grid file stores a versioned header, the receiver coordinates (sorted\n"
+    "by id, as rfpos_stream orders them) and float ranges from every node to\n"
+    "every receiver; it is memory-mapped as is at startup.\n");
+}
+//----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  const char *layout = (const char*) 0, *oname = (const char*) 0;
+  const char *box = (const char*) 0;
+  int c, i, j, n, d = 3, retv;
+  double step = 1., margin = 10., lo[RFPOS_D_MAX], hi[RFPOS_D_MAX], *m;
+  long long nodes = 1;
+  mkgrid_rx_t *rx = (mkgrid_rx_t*) 0;
+
+  while ((c = getopt(argc, argv, "l:o:d:s:m:b:h")) != -1)
+  {
+    switch (c)
+    {
+      case 'l': layout = optarg;         break;
+      case 'o': oname  = optarg;         break;
+      case 'd': d      = atoi(optarg);   break;
+      case 's': step   = atof(optarg);   break;
+      case 'm': margin = atof(optarg);   break;
+      case 'b': box    = optarg;         break;
+      default:  usage(); return c == 'h' ? 0 : 1;
+    }
+  }
+
+  if (!layout || !oname || d < 2 || d > RFPOS_D_MAX || !(step > 0.) ||
+      optind != argc)
+  {
+    usage();
+    return 1;
+  }
+
+  n = rx_load(layout, d, &rx);
+  if (n < 0)
+    return 1;
+
+  m = (double*) malloc(sizeof(double) * n * d);
+  if (!m)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++)
+    for (j = 0; j < d; j++)
+      m[i * d + j] = rx[i].s[j];
+
+  if (box)
+  { // явно заданная область
+    char *p = (char*) box, *e;
+    for (j = 0; j < 2 * d; j++)
+    {
+      p = skip_sep(p);
+      (j < d ? lo : hi)[j % d] = strtod(p, &e);
+      if (e == p)
+      {
+        fprintf(stderr, "error: bad volume '%s'\n", box);
+        return 1;
+      }
+      p = e;
+    }
+  }
+  else
+  { // область приёмников с запасом
+    for (j = 0; j < d; j++)
+    {
+      lo[j] = hi[j] = m[j];
+      for (i = 1; i < n; i++)
+      {
+        if (lo[j] > m[i * d + j]) lo[j] = m[i * d + j];
+        if (hi[j] < m[i * d + j]) hi[j] = m[i * d + j];
+      }
+      lo[j] -= margin;
+      hi[j] += margin;
+    }
+  }
+
+  for (j = 0; j < d; j++)
+    nodes *= (long long) ((hi[j] - lo[j]) / step + 1e-9) + 1;
+  fprintf(stderr, "receivers: %i, nodes: %lli, file size: %.1f MB\n",
+          n, nodes, (double) nodes * n * sizeof(float) / 1048576.);
+
+  retv = rfpos_grid_build(oname, d, n, m, lo, hi, step);
+  if (retv < 0)
+    fprintf(stderr, "error: can't build grid file '%s' (%i)\n", oname, retv);
+
+  free(m);
+  free(rx);
+
+  return retv < 0;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_mkgrid.c" ***/
@@ -1465,5 +1465,379 @@ err:
   return x;
 }
 //----------------------------------------------------------------------------
+// разложение Холецкого симметричной положительно определенной матрицы
+// "на месте": A = L x L^(T), L записывается в нижний треугольник `a`
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_chol(la_matrix_t *a)
+{
+  int i, j, k, n = a->nrow;
+  la_float_t s;
+
+  for (j = 0; j < n; j++)
+  {
+    la_float_t *aj = a->d[j];
+
+    s = aj[j];
+    for (k = 0; k < j; k++)
+      s -= aj[k] * aj[k];
+    if (s <= 0.)
+    {
+      LA_DBG("error: matrix is not positive definite in la_chol()");
+      return -1;
+    }
+    s = sqrt(s);
+    aj[j] = s;
+    s = 1. / s;
+
+    for (i = j + 1; i < n; i++)
+    {
+      la_float_t *ai = a->d[i];
+      la_float_t q = ai[j];
+      for (k = 0; k < j; k++)
+        q -= ai[k] * aj[k];
+      ai[j] = q * s;
+    }
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// решение системы (L x L^(T)) x X = B "на месте" (B заменяется на X)
+// по разложению Холецкого, полученному la_chol()
+void la_chol_solve(const la_matrix_t *l, la_vector_t *b)
+{
+  int i, k, n = l->nrow;
+  la_float_t s;
+
+  // прямая подстановка: L x Z = B
+  for (i = 0; i < n; i++)
+  {
+    s = b->d[i];
+    for (k = 0; k < i; k++)
+      s -= l->d[i][k] * b->d[k];
+    b->d[i] = s / l->d[i][i];
+  }
+
+  // обратная подстановка: L^(T) x X = Z
+  for (i = n - 1; i >= 0; i--)
+  {
+    s = b->d[i];
+    for (k = i + 1; k < n; k++)
+      s -= l->d[k][i] * b->d[k];
+    b->d[i] = s / l->d[i][i];
+  }
+}
+//----------------------------------------------------------------------------
+// обращение матрицы A = L x L^(T) по разложению Холецкого, полученному
+// la_chol(): A^(-1) = L^(-T) x L^(-1) (матрица `x` не совпадает с `l`)
+void la_chol_inv(const la_matrix_t *l, la_matrix_t *x)
+{
+  int i, j, k, n = l->nrow;
+  la_float_t s;
+
+  // M = L^(-1) в нижний треугольник `x`
+  for (j = 0; j < n; j++)
+  {
+    x->d[j][j] = 1. / l->d[j][j];
+    for (i = j + 1; i < n; i++)
+    {
+      s = 0.;
+      for (k = j; k < i; k++)
+        s -= l->d[i][k] * x->d[k][j];
+      x->d[i][j] = s / l->d[i][i];
+    }
+  }
+
+  // A^(-1) = M^(T) x M в верхний треугольник (диагональный элемент
+  // столбца i записывается последним - больше он не нужен)
+  for (i = 0; i < n; i++)
+    for (j = n - 1; j >= i; j--)
+    {
+      s = 0.;
+      for (k = j; k < n; k++)
+        s += x->d[k][i] * x->d[k][j];
+      x->d[i][j] = s;
+    }
+
+  // симметричное дополнение
+  for (i = 1; i < n; i++)
+    for (j = 0; j < i; j++)
+      x->d[i][j] = x->d[j][i];
+}
+//----------------------------------------------------------------------------
+// изменение ранга 1 разложения Холецкого "на месте": A +/- V x V^(T)
+// (вращения столбцов L, вектор `v` портится)
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_chol_update(la_matrix_t *l, la_vector_t *v, int sign)
+{
+  int i, k, n = l->nrow;
+  la_float_t r, c, s, lk, *x = v->d;
+
+  for (k = 0; k < n; k++)
+  {
+    lk = l->d[k][k];
+    r = sign > 0 ? lk * lk + x[k] * x[k] : lk * lk - x[k] * x[k];
+    if (!(r > 0.))
+    {
+      LA_DBG("error: matrix is not positive definite in la_chol_update()");
+      return -1;
+    }
+    r = sqrt(r);
+    c = r / lk;
+    s = x[k] / lk;
+    l->d[k][k] = r;
+
+    for (i = k + 1; i < n; i++)
+    {
+      la_float_t *li = l->d[i];
+      if (sign > 0)
+        li[k] = (li[k] + s * x[i]) / c;
+      else
+        li[k] = (li[k] - s * x[i]) / c;
+      x[i] = c * x[i] - s * li[k];
+    }
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// решение системы A x X = B методом Гаусса-Жордана с выбором главного
+// элемента по столбцу "на месте" для расширенной матрицы [A | B]
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_gauss(la_matrix_t *a)
+{
+  int i, j, k, n = a->nrow, m = a->ncol;
+
+#ifdef LA_PARANOIC
+  if (m < n)
+  {
+    LA_DBG("error: bad arguments in la_gauss()");
+    return -1;
+  }
+#endif // LA_PARANOIC
+
+  for (k = 0; k < n; k++)
+  {
+    // поиск главного элемента в столбце k
+    int p = k;
+    la_float_t big = fabs(a->d[k][k]), q;
+    for (i = k + 1; i < n; i++)
+      if (fabs(a->d[i][k]) > big)
+      {
+        big = fabs(a->d[i][k]);
+        p = i;
+      }
+    if (big == 0.)
+    {
+      LA_DBG("error: singular matrix in la_gauss()");
+      return -2;
+    }
+    if (p != k)
+      la_matrix_swap_row(a, k, p);
+
+    // нормировать строку k
+    q = 1. / a->d[k][k];
+    for (j = k; j < m; j++)
+      a->d[k][j] *= q;
+
+    // исключить столбец k из остальных строк
+    for (i = 0; i < n; i++)
+    {
+      if (i == k) continue;
+      q = a->d[i][k];
+      if (q == 0.) continue;
+      for (j = k; j < m; j++)
+        a->d[i][j] -= q * a->d[k][j];
+    }
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// инициализация рабочего пространства (выделение памяти)
+// для систем с числом неизвестных не более n
+void la_svd_ws_init(la_svd_ws_t *ws, int n)
+{
+  la_matrix_init(&ws->a, n, n);
+}
+//----------------------------------------------------------------------------
+// деинициализация рабочего пространства (освобождение памяти)
+void la_svd_ws_free(la_svd_ws_t *ws)
+{
+  la_matrix_free(&ws->a);
+}
+//----------------------------------------------------------------------------
+// решение переопределенной системы линейных уравнений (m > n)
+// (поиск X при котором A x X = Y) методом нормальных уравнений
+// с разложением Холецкого без выделения памяти
+int la_svd_simple_ws(
+  const la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n]
+  const la_vector_t *y, // столбец правых частей [m]
+  la_vector_t *x,       // решение [n] (память выделяется вызывающим)
+  la_svd_ws_t *ws)      // рабочее пространство (не менее n неизвестных)
+{
+  int i, j, k, m = a->nrow, n = a->ncol;
+  la_matrix_t c = ws->a; // используется левый верхний угол [n][n]
+  c.nrow = c.ncol = n;
+
+#ifdef LA_PARANOIC
+  if (y->size != m || x->size < n || m < n || ws->a.nrow < n)
+  {
+    LA_DBG("error: bad arguments in la_svd_simple_ws()");
+    return -1;
+  }
+#endif // LA_PARANOIC
+
+  // вычислить нижний треугольник c = a^(T) * a и вектор x = a^(T) * y
+  for (i = 0; i < n; i++)
+  {
+    la_float_t s;
+    for (j = 0; j <= i; j++)
+    {
+      s = 0.;
+      for (k = 0; k < m; k++)
+        s += a->d[k][i] * a->d[k][j];
+      c.d[i][j] = s;
+    }
+    s = 0.;
+    for (k = 0; k < m; k++)
+      s += a->d[k][i] * y->d[k];
+    x->d[i] = s;
+  }
+
+  // разложение Холецкого и решение (a^(T) * a) * x = a^(T) * y
+  if (la_chol(&c) < 0)
+  {
+    LA_DBG("error: la_chol() return error in la_svd_simple_ws()");
+    for (i = 0; i < n; i++)
+      x->d[i] = 0.;
+    return -2;
+  }
+  la_chol_solve(&c, x);
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// решение переопределенной системы линейных уравнений (m >= n) методом
+// наименьших квадратов отражениями Хаусхолдера "на месте"
+int la_qr_solve(
+  la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n] (разрушается)
+  la_vector_t *y, // столбец правых частей [m] (разрушается)
+  la_vector_t *x) // решение [n] (память выделяется вызывающим)
+{
+  int i, j, k, m = a->nrow, n = a->ncol;
+  la_float_t s, q, al, vk, tau;
+
+#ifdef LA_PARANOIC
+  if (y->size < m || x->size < n || m < n)
+  {
+    LA_DBG("error: bad arguments in la_qr_solve()");
+    return -1;
+  }
+#endif // LA_PARANOIC
+
+  for (k = 0; k < n; k++)
+  {
+    // отражение H = I - tau * v * v^(T), переводящее столбец k
+    // (строки k...m-1) в (al, 0, ..., 0): v = (a[k][k] - al, a[k+1][k], ...)
+    s = 0.;
+    for (i = k; i < m; i++)
+      s += a->d[i][k] * a->d[i][k];
+    if (s == 0.)
+    {
+      LA_DBG("error: singular matrix in la_qr_solve()");
+      return -2;
+    }
+    al = sqrt(s);
+    if (a->d[k][k] > 0.) al = -al; // без вычитания близких чисел
+    vk = a->d[k][k] - al;
+    a->d[k][k] = vk;
+    tau = -1. / (al * vk); // 2 / (v^(T) * v)
+
+    // применить отражение к остальным столбцам и к правым частям
+    for (j = k + 1; j < n; j++)
+    {
+      q = 0.;
+      for (i = k; i < m; i++)
+        q += a->d[i][k] * a->d[i][j];
+      q *= tau;
+      for (i = k; i < m; i++)
+        a->d[i][j] -= q * a->d[i][k];
+    }
+    q = 0.;
+    for (i = k; i < m; i++)
+      q += a->d[i][k] * y->d[i];
+    q *= tau;
+    for (i = k; i < m; i++)
+      y->d[i] -= q * a->d[i][k];
+
+    a->d[k][k] = al; // диагональ R
+  }
+
+  // обратная подстановка: R x X = (Q^(T) x Y)[0...n-1]
+  for (i = n - 1; i >= 0; i--)
+  {
+    s = y->d[i];
+    for (j = i + 1; j < n; j++)
+      s -= a->d[i][j] * x->d[j];
+    x->d[i] = s / a->d[i][i];
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// инициализация рабочего пространства la_qr_solve_ws() (выделение памяти)
+void la_qr_ws_init(la_qr_ws_t *ws, int m, int n)
+{
+  la_matrix_init(&ws->a, m, n);
+  la_vector_init(&ws->y, m);
+}
+//----------------------------------------------------------------------------
+// деинициализация рабочего пространства (освобождение памяти)
+void la_qr_ws_free(la_qr_ws_t *ws)
+{
+  la_vector_free(&ws->y);
+  la_matrix_free(&ws->a);
+}
+//----------------------------------------------------------------------------
+// решение переопределенной системы линейных уравнений (m >= n) отражениями
+// Хаусхолдера в рабочем пространстве (A и Y не изменяются)
+int la_qr_solve_ws(
+  const la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n]
+  const la_vector_t *y, // столбец правых частей [m]
+  la_vector_t *x,       // решение [n] (память выделяется вызывающим)
+  la_qr_ws_t *ws)       // рабочее пространство (не менее m x n)
+{
+  int i, j, m = a->nrow, n = a->ncol;
+  la_matrix_t c = ws->a; // используется левый верхний угол [m][n]
+  la_vector_t v = ws->y;
+  c.nrow = v.size = m;
+  c.ncol = n;
+
+#ifdef LA_PARANOIC
+  if (y->size != m || ws->a.nrow < m || ws->a.ncol < n)
+  {
+    LA_DBG("error: bad arguments in la_qr_solve_ws()");
+    return -1;
+  }
+#endif // LA_PARANOIC
+
+  for (i = 0; i < m; i++)
+  {
+    for (j = 0; j < n; j++)
+      c.d[i][j] = a->d[i][j];
+    v.d[i] = y->d[i];
+  }
+
+  if (la_qr_solve(&c, &v, x) < 0)
+  {
+    for (i = 0; i < n; i++)
+      x->d[i] = 0.;
+    return -2;
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
 
 /*** end of "la.c" file ***/
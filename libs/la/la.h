@@ -124,6 +124,20 @@ typedef struct {
   la_float_t **d; // matrix data (указатели на начало строк)
 } la_matrix_t;
 
+// рабочее пространство для решения переопределенной системы линейных
+// уравнений без выделения памяти (см. la_svd_simple_ws())
+typedef struct {
+  la_matrix_t a; // матрица нормальных уравнений A^(T) * A [n][n]
+} la_svd_ws_t;
+
+// рабочее пространство для решения переопределенной системы линейных
+// уравнений отражениями Хаусхолдера без изменения исходных данных
+// (см. la_qr_solve_ws())
+typedef struct {
+  la_matrix_t a; // копия матрицы коэффициентов [m][n]
+  la_vector_t y; // копия столбца правых частей [m]
+} la_qr_ws_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
@@ -391,6 +405,86 @@ la_vector_t la_svd_full(
   const la_matrix_t *n, // корреляционная матрица правых частей Y [m][m]
   int *err);            // код ошибки (при ошибке <0, при успехе 0)
 
+// ***********************************************************
+// функции, не выделяющие память (работают "на месте" или
+// в заранее выделенном рабочем пространстве)
+// ***********************************************************
+
+// разложение Холецкого симметричной положительно определенной матрицы
+// "на месте": A = L x L^(T), L записывается в нижний треугольник `a`
+// (используется только нижний треугольник; верхний не изменяется)
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_chol(la_matrix_t *a);
+
+// решение системы (L x L^(T)) x X = B "на месте" (B заменяется на X)
+// по разложению Холецкого, полученному la_chol()
+void la_chol_solve(const la_matrix_t *l, la_vector_t *b);
+
+// обращение матрицы A = L x L^(T) по разложению Холецкого, полученному
+// la_chol(); результат A^(-1) [n][n] записывается в матрицу `x`
+// (не совпадающую с `l`) целиком
+void la_chol_inv(const la_matrix_t *l, la_matrix_t *x);
+
+// изменение ранга 1 разложения Холецкого "на месте": по L (A = L x L^(T))
+// находится разложение A + V x V^(T) (sign > 0) или A - V x V^(T)
+// (sign < 0) за O(n^2) без повторного разложения; вектор `v` портится
+// (в случае успеха возвращается 0, ошибки - <0: после вычитания матрица
+// не положительно определена, L испорчено)
+int la_chol_update(la_matrix_t *l, la_vector_t *v, int sign);
+
+// решение системы A x X = B методом Гаусса-Жордана с выбором главного
+// элемента по столбцу "на месте" для расширенной матрицы [A | B] размера
+// [n][n+k]; решения записываются в последние k столбцов (строки матрицы
+// переставляются перестановкой указателей)
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_gauss(la_matrix_t *a);
+
+// инициализация рабочего пространства (выделение памяти)
+// для систем с числом неизвестных не более n
+void la_svd_ws_init(la_svd_ws_t *ws, int n);
+
+// деинициализация рабочего пространства (освобождение памяти)
+void la_svd_ws_free(la_svd_ws_t *ws);
+
+// решение переопределенной системы линейных уравнений (m > n)
+// (поиск X при котором A x X = Y) методом нормальных уравнений
+// с разложением Холецкого без выделения памяти.
+// Результат аналогичен la_svd_simple().
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_svd_simple_ws(
+  const la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n]
+  const la_vector_t *y, // столбец правых частей [m]
+  la_vector_t *x,       // решение [n] (память выделяется вызывающим)
+  la_svd_ws_t *ws);     // рабочее пространство (не менее n неизвестных)
+
+// решение переопределенной системы линейных уравнений (m >= n) методом
+// наименьших квадратов (поиск X, при котором |A x X - Y| минимален)
+// за один проход отражений Хаусхолдера "на месте": A заменяется на R
+// (верхний треугольник; под диагональю остаются хвосты векторов
+// отражений), Y - на Q^(T) x Y; в отличие от la_svd_simple() матрица
+// A^(T) x A не строится и число обусловленности не возводится в квадрат
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_qr_solve(
+  la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n] (разрушается)
+  la_vector_t *y, // столбец правых частей [m] (разрушается)
+  la_vector_t *x);// решение [n] (память выделяется вызывающим)
+
+// инициализация рабочего пространства la_qr_solve_ws() (выделение памяти)
+// для систем с числом уравнений не более m и неизвестных не более n
+void la_qr_ws_init(la_qr_ws_t *ws, int m, int n);
+
+// деинициализация рабочего пространства (освобождение памяти)
+void la_qr_ws_free(la_qr_ws_t *ws);
+
+// то же, что la_qr_solve(), но A и Y не изменяются (копируются
+// в рабочее пространство, выделенное вызывающим)
+// (в случае успеха возвращается 0, ошибки - <0)
+int la_qr_solve_ws(
+  const la_matrix_t *a, // матрица коэффициентов [nrow=m][ncol=n]
+  const la_vector_t *y, // столбец правых частей [m]
+  la_vector_t *x,       // решение [n] (память выделяется вызывающим)
+  la_qr_ws_t *ws);      // рабочее пространство (не менее m x n)
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -210,11 +210,12 @@ int main()
   if (1)
   {
     int i, j, k, nx = 200, ny = 400;
-    double t1, t2, t3;
+    double t1, t2, t3, t4;
     la_matrix_t a;
     la_vector_t n;
     la_vector_t y;
-    la_vector_t x1, x2;
+    la_vector_t x1, x2, x3;
+    la_qr_ws_t ws;
 
     la_matrix_init(&a, ny, nx);
     la_vector_init(&n, ny);
@@ -238,16 +239,25 @@ int main()
     t2 = get_rt();
     x2 = la_svd_simple(&a, &y, &j);
     t3 = get_rt();
+    la_qr_ws_init(&ws, ny, nx);
+    la_vector_init(&x3, nx);
+    t4 = get_rt();
+    k = la_qr_solve_ws(&a, &y, &x3, &ws);
+    t4 = get_rt() - t4;
     
     
     fprintf(stdout, "la_matrix_rang(a) = %i\n", la_matrix_rang(&a));
     fprintf(stdout, "t2 - t1 = %f\n", t2 - t1);
     fprintf(stdout, "t3 - t2 = %f\n", t3 - t2);
-    fprintf(stdout, "err_svd = %i err_svd_simple = %i\n", i, j);
+    fprintf(stdout, "la_qr_solve_ws() t = %f\n", t4);
+    fprintf(stdout, "err_svd = %i err_svd_simple = %i err_qr = %i\n", i, j, k);
     la_vector_print(&x1, stdout);
     la_vector_print(&x2, stdout);
+    la_vector_print(&x3, stdout);
     fprintf(stdout, "\n");
     
+    la_qr_ws_free(&ws);
+    la_vector_free(&x3);
     la_vector_free(&x1);
     la_vector_free(&x2);
     la_vector_free(&y);
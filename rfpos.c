@@ -7,10 +7,25 @@
  * Licensed by GNU General Public License version 2
  */
 //----------------------------------------------------------------------------
-#include <math.h> // sqrt()
-#include <stdio.h> // printf()
+#include <math.h> // sqrt(), pow(), log(), atan2(), acos()
+#include <time.h> // clock_gettime()
+#include <string.h> // memset()
 #include "rfpos.h"
 //----------------------------------------------------------------------------
+// состояние нормальной матрицы self->ws.a после итераций (поле `fa`)
+#define RFPOS_FA_NONE 0 // не соответствует решению
+#define RFPOS_FA_RAW  1 // W^(T) * C * W в последней точке (нижний треугольник)
+#define RFPOS_FA_CHOL 2 // разложение Холецкого W^(T) * C * W
+//----------------------------------------------------------------------------
+// состояние разложения self->ul (поле `uc`, rfpos_calc_add())
+#define RFPOS_UC_NONE 0 // нет решённого импульса
+#define RFPOS_UC_X    1 // self->x - решение импульса, разложение не построено
+#define RFPOS_UC_CHOL 2 // ul, ub - разложение и вектор в точке self->x
+//----------------------------------------------------------------------------
+// порог вырожденности симметричной матрицы d x d в rfpos_inv_sym()
+// (отношение определителя к d-й степени следа)
+#define RFPOS_SUB_EPS 1e-12
+//----------------------------------------------------------------------------
 // инициализация основного компонента, выделение памяти
 // (в случае ошибки возвращается отрицательный код ошибки)
 void rfpos_init(
@@ -18,179 +33,2375 @@ void rfpos_init(
   int d,         // максимальная размерность координат (2 или 3)
   int n)         // максимальное число приёмников
 {
+  int i;
+
   if (d < 2) d = 2;
+  if (d > RFPOS_D_MAX) d = RFPOS_D_MAX;
   if (n <= d) n = d + 1;
 
   self->n = n;
   self->d = d;
 
-  la_matrix_init(&self->y, n, d + 1); // матрица входных данных
+  la_matrix_init(&self->y, d + 1, n); // матрица входных данных
+  la_vector_init(&self->sw, n);       // веса приёмников
   la_vector_init(&self->x, d + 1);    // искомый вектор
-  la_vector_init(&self->f, n);        // вектор "невязки"
-  la_matrix_init(&self->w, n, d + 1); // матрица Якоби
+  la_vector_init(&self->dx, d + 1);   // поправка
+  la_svd_ws_init(&self->ws, d + 1);   // рабочее пространство
+  la_matrix_init(&self->g, d + 1, d + 3); // расширенная матрица
+  la_matrix_init(&self->wq, n, d + 1);    // матрица Якоби (RFPOS_OPT_QR)
+  la_vector_init(&self->fq, n);           // вектор невязки (RFPOS_OPT_QR)
+  la_matrix_init(&self->ul, d + 1, d + 1); // разложение (rfpos_calc_add())
+  la_vector_init(&self->ub, d + 1);
+  self->uc = RFPOS_UC_NONE;
+
+  // решённого импульса ещё нет (rfpos_cov() возвращает RFPOS_ERR_ST)
+  self->nl = self->dl = 0;
+  self->fa = RFPOS_FA_NONE;
+  self->wt = self->kc = self->kf = 0;
+  self->sv = self->nc = 0;
+  self->tmin = 0.;
+
+  // выбрать ядро совмещенного прохода по возможностям процессора
+  self->simd = rfpos_simd_detect();
+  self->fw[2] = rfpos_simd_fw(self->simd, 2);
+  self->fw[3] = rfpos_simd_fw(self->simd, 3);
+  self->sc[2] = rfpos_simd_sc(self->simd, 2);
+  self->sc[3] = rfpos_simd_sc(self->simd, 3);
+  self->fwf[2] = rfpos_simd_fwf(self->simd, 2);
+  self->fwf[3] = rfpos_simd_fwf(self->simd, 3);
+  self->td[2] = rfpos_simd_td(self->simd, 2);
+  self->td[3] = rfpos_simd_td(self->simd, 3);
+  self->gr[2] = rfpos_simd_gr(self->simd, 2);
+  self->gr[3] = rfpos_simd_gr(self->simd, 3);
+  self->rs = 2463534242u;
+
+  // столбцы и веса одинарной точности (RFPOS_OPT_F32), при нехватке
+  // памяти режим RFPOS_OPT_F32 не действует
+  self->fb = (float*) la_malloc(sizeof(float) * (d + 3) * n);
+  for (i = 0; i < d + 2; i++)
+    self->yf[i] = self->fb ? self->fb + i * n : (float*) 0;
+  self->swf = self->fb ? self->fb + (d + 2) * n : (float*) 0;
+  self->sub = (const rfpos_sub_t*) 0;
+
+  self->opt = RFPOS_OPT_NONE;
+  self->tdl = 0.;
+
+#ifdef RFPOS_STATS
+  memset(&self->stat, 0, sizeof(rfpos_stat_t));
+  memset(&self->trace, 0, sizeof(rfpos_trace_t));
+#endif // RFPOS_STATS
 }
 //----------------------------------------------------------------------------
 // деинициализация компонента, освобождение памяти
 void rfpos_free(rfpos_t *self)
 {
-  la_matrix_free(&self->w);
-  la_vector_free(&self->f);
+  la_free(self->fb);
+  la_vector_free(&self->ub);
+  la_matrix_free(&self->ul);
+  la_vector_free(&self->fq);
+  la_matrix_free(&self->wq);
+  la_matrix_free(&self->g);
+  la_svd_ws_free(&self->ws);
+  la_vector_free(&self->dx);
   la_vector_free(&self->x);
+  la_vector_free(&self->sw);
   la_matrix_free(&self->y);
 }
 //----------------------------------------------------------------------------
-// функция вычисления вектора невязки F(X,Y)
-static void rfpos_f(
-    int n, int d,         // число приёмников, размерность задачи
-    const la_vector_t *x, // выбранная точка в пространстве и времени
-    const la_matrix_t *y, // входные данные
-    la_vector_t *f)       // значение невязки
+// совмещенный проход по приёмникам (см. "rfpos_simd.h"): за одно чтение
+// столбцов Y вычисляются невязка F(X,Y), строки матрицы Якоби W(X,Y),
+// нижний треугольник нормальной матрицы A = W^(T) * W и вектор B = W^(T) * F
+// (ни F, ни W в памяти не сохраняются; возвращается |F|^2; для взвешенного
+// МНК - W^(T) * C * W, W^(T) * C * F и F^(T) * C * F)
+static double rfpos_fw(
+    rfpos_t *self,  // структура данных компонента
+    int n, int d,   // число приёмников, размерность задачи
+    la_matrix_t *a, // нормальная матрица W^(T) * W [d+1][d+1]
+    la_vector_t *b) // вектор W^(T) * F [d+1]
+{
+  int j, k, l, u = d + 1;
+  double fm, x[RFPOS_U_MAX], s[RFPOS_U_MAX * (RFPOS_U_MAX + 1) / 2];
+  double v[RFPOS_U_MAX];
+
+  for (j = 0; j < u; j++)
+    x[j] = self->x.d[j];
+
+  fm = self->fw[d](n, x, self->y.d, self->wt ? self->sw.d : NULL,
+                   self->kc ? self->y.d[d + 1] : NULL, s, v);
+
+  for (j = 0, l = 0; j < u; j++)
+  {
+    for (k = 0; k <= j; k++, l++)
+      a->d[j][k] = s[l];
+    b->d[j] = v[j];
+  }
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// проход по приёмникам без нормальной матрицы (режим RFPOS_OPT_CHORD):
+// вычисляется только вектор W^(T) * F (возвращается |F|^2)
+static double rfpos_gr(
+    rfpos_t *self,  // структура данных компонента
+    int n, int d,   // число приёмников, размерность задачи
+    la_vector_t *b) // вектор W^(T) * F [d+1]
+{
+  int j, u = d + 1;
+  double fm, x[RFPOS_U_MAX], v[RFPOS_U_MAX];
+
+  for (j = 0; j < u; j++)
+    x[j] = self->x.d[j];
+
+  fm = self->gr[d](n, x, self->y.d, self->wt ? self->sw.d : NULL,
+                   self->kc ? self->y.d[d + 1] : NULL, v);
+
+  for (j = 0; j < u; j++)
+    b->d[j] = v[j];
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// квадрат модуля вектора невязки F(X,Y) по всем n приёмникам в точке x
+// (используется для проверки пробного шага без построения нормальных
+// уравнений; для взвешенного МНК - F^(T) * C * F, см. "rfpos_simd.h")
+static double rfpos_f(
+    int n, int d,          // число приёмников, размерность задачи
+    const double *x,       // точка в пространстве и времени [d+1]
+    la_float_t *const *y,  // столбцы входных данных [d+1][n]
+    const la_float_t *sw,  // веса 1/(2*C*sigma)^2 [n] или NULL
+    const la_float_t *cf)  // постоянные слагаемые невязки [n] или NULL
 {
   int i, j;
+  double fm = 0.;
 
   for (i = 0; i < n; i++)
   {
     double s = 0., q;
     for (j = 0; j < d; j++)
     {
-      q = x->d[j] - y->d[i][j];
+      q = x[j] - y[j][i];
       s += q * q;
     }
-    q = x->d[d] - y->d[i][d];
-    f->d[i] = s - q * q;
+    q = x[d] - y[d][i];
+    s -= q * q;
+    if (cf) s += cf[i];
+    if (sw)
+    {
+      q *= q;
+      if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      fm += sw[i] / q * s * s;
+    }
+    else
+      fm += s * s;
   }
+
+  return fm;
 }
 //----------------------------------------------------------------------------
-// функция вычисления значения матрицы Якоби W(X,Y)
-static void rfpos_w(
-    int n, int d,         // число приёмников, размерность задачи
-    const la_vector_t *x, // выбранная точка в пространстве и времени
-    const la_matrix_t *y, // входные данные
-    la_matrix_t *w)       // матрица Якоби
+// матрица Якоби W(X,Y) и вектор невязки F(X,Y) в точке self->x в явном
+// виде (для разложения QR); для взвешенного МНК строки W и элементы F
+// умножаются на sqrt(c[i]) (см. "rfpos_simd.h")
+// (возвращается |F|^2, для взвешенного МНК - F^(T) * C * F)
+static double rfpos_wf(
+    rfpos_t *self,  // структура данных компонента
+    int n, int d,   // число приёмников, размерность задачи
+    la_matrix_t *w, // матрица Якоби W [n][d+1]
+    la_vector_t *f) // вектор невязки F [n]
 {
   int i, j;
-  
+  double fm = 0., q, s, c, x[RFPOS_U_MAX];
+  la_float_t **y = self->y.d;
+
+  for (j = 0; j <= d; j++)
+    x[j] = self->x.d[j];
+
   for (i = 0; i < n; i++)
   {
+    la_float_t *wi = w->d[i];
+    s = 0.;
     for (j = 0; j < d; j++)
-      w->d[i][j] = 2. * (x->d[j] - y->d[i][j]);
-    w->d[i][d] =  -2. * (x->d[d] - y->d[i][d]); 
+    {
+      q = x[j] - y[j][i];
+      wi[j] = 2. * q;
+      s += q * q;
+    }
+    q = x[d] - y[d][i];
+    wi[d] = -2. * q;
+    s -= q * q;
+    if (self->kc) s += y[d + 1][i];
+
+    if (self->wt)
+    {
+      q *= q;
+      if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      c = sqrt(self->sw.d[i] / q);
+      for (j = 0; j <= d; j++)
+        wi[j] *= c;
+      s *= c;
+    }
+
+    f->d[i] = s;
+    fm += s * s;
   }
+
+  return fm;
 }
 //----------------------------------------------------------------------------
-// основная функция для численного решения системы квадратных уравнений
-// (в случае ошибки возвращается отрицательный код ошибки,
-// в случае успеха - число выполненных итераций)
-// координаты передаются и возвращаются в метрах, время в секундах
-int rfpos_calc(
-  rfpos_t *self, // структура данных компонента
-  // на входе:
-  int it,          // максимальное число итераций
-  double e,        // желаемая численная точность оценки координат [м]
-  int d,           // размерность координат или число неизвестных (2 или 3)
-  int n,           // число приёмников, принявших задержанный сигнал (n > d)
-  const double *m, // матрица координат приёмников [n][d]
-  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
-  const double *p, // радиус вектор предполагаемого нахождения приёмника [d]
-  // на выходе:
-  double *t0, // оценка времени излучения сигнала передатчиком
-  double *r)  // радиус вектор приёмника, если решение найдено [d]
+// заполнить матрицу исходных данных self->y
+// (idx - индексы строк в матрице координат приёмников m или NULL)
+static void rfpos_load(
+  rfpos_t *self,   // структура данных компонента
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал
+  const double *m, // матрица координат приёмников [][d]
+  const int *idx,  // индексы приёмников в матрице m [n] или NULL
+  const double *t, // вектор временных меток приёма сигнала [n]
+  const double *s) // СКО временных меток [n] или NULL
 {
   int i, j;
-  double tmin, d0;
+  double tmin;
   const double *ptr;
-  
-  if (n > self->n) return -1; // ошибка
-  if (d > self->d) return -2; // ошибка
-  
+
+  // веса взвешенного МНК: 1 / (2 * C * sigma)^2
+  self->nl = n;
+  self->dl = d;
+  self->fa = RFPOS_FA_NONE;
+  self->uc = RFPOS_UC_NONE;
+  self->sv = self->nc = 0;
+  self->kc = 0;
+  self->wt = s != (const double*) 0;
+  for (i = 0; self->wt && i < n; i++)
+  {
+    double q = 2. * RFPOS_C * s[i];
+    self->sw.d[i] = 1. / (q * q);
+  }
+
   // найти минимальное значение t[i]
   tmin = t[0];
   for (i = 1; i < n; i++)
     if (tmin > t[i]) tmin = t[i];
+  self->tmin = tmin;
+
+  // заполнить матрицу исходных данных (по столбцам)
+  for (i = 0; i < n; i++)
+  {
+    ptr = idx ? m + idx[i] * d : m + i * d;
+    for (j = 0; j < d; j++)
+      self->y.d[j][i] = ptr[j];
+
+    self->y.d[d][i] = (t[i] - tmin) * RFPOS_C; // секунды -> метры
+  }
+}
+//----------------------------------------------------------------------------
+// заполнить матрицу исходных данных self->y импульсом в местных
+// координатах площадки (см. `rfpos_batch_f_t`); координаты остаются
+// относительно начала площадки, self->tmin - абсолютное время
+static void rfpos_load_f(
+  rfpos_t *self,   // структура данных компонента
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал
+  const float *m,  // координаты приёмников относительно начала [][d]
+  const int *idx,  // индексы приёмников в матрице m [n]
+  double tb,       // опорное время импульса [с]
+  const float *t,  // смещения временных меток от tb [n] [с]
+  const float *s)  // СКО временных меток [n] или NULL
+{
+  int i, j;
+  double tmin;
+  const float *ptr;
+
+  self->nl = n;
+  self->dl = d;
+  self->fa = RFPOS_FA_NONE;
+  self->uc = RFPOS_UC_NONE;
+  self->sv = self->nc = 0;
+  self->kc = 0;
+  self->wt = s != (const float*) 0;
+  for (i = 0; self->wt && i < n; i++)
+  {
+    double q = 2. * RFPOS_C * (double) s[i];
+    self->sw.d[i] = 1. / (q * q);
+  }
+
+  tmin = t[0];
+  for (i = 1; i < n; i++)
+    if (tmin > t[i]) tmin = t[i];
+  self->tmin = tb + tmin;
+
+  for (i = 0; i < n; i++)
+  {
+    ptr = m + idx[i] * d;
+    for (j = 0; j < d; j++)
+      self->y.d[j][i] = (double) ptr[j];
+
+    self->y.d[d][i] = ((double) t[i] - tmin) * RFPOS_C; // секунды -> метры
+  }
+}
+//----------------------------------------------------------------------------
+// обращение симметричной положительно определённой матрицы d x d (d = 2, 3)
+// через алгебраические дополнения
+// (в случае успеха возвращается 0, для вырожденной матрицы - <0)
+static int rfpos_inv_sym(
+  int d,                                // размерность (2 или 3)
+  double a[RFPOS_D_MAX][RFPOS_D_MAX],   // исходная матрица
+  double ai[RFPOS_D_MAX][RFPOS_D_MAX])  // обратная матрица
+{
+  int j, k;
+  double det, tr;
+
+  if (d == 2)
+  {
+    det = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    tr  = a[0][0] + a[1][1];
+    if (!(det > RFPOS_SUB_EPS * tr * tr))
+      return -1;
+    ai[0][0] =  a[1][1];
+    ai[0][1] = -a[0][1];
+    ai[1][0] = -a[1][0];
+    ai[1][1] =  a[0][0];
+  }
+  else
+  {
+    ai[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    ai[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+    ai[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+    ai[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+    ai[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+    ai[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+    ai[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+    ai[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+    ai[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    det = a[0][0] * ai[0][0] + a[0][1] * ai[1][0] + a[0][2] * ai[2][0];
+    tr  = a[0][0] + a[1][1] + a[2][2];
+    if (!(det > RFPOS_SUB_EPS * tr * tr * tr))
+      return -1;
+  }
+
+  for (j = 0; j < d; j++)
+    for (k = 0; k < d; k++)
+      ai[j][k] /= det;
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// линеаризованная исходная точка по данным подмножества self->sub
+// (опорный приёмник - первый): нормальные уравнения rfpos_guess_lin()
+//   [ G    c ] [ X - S[0] ]   [ h ]
+//   [ c^T  g ] [    d0    ] = [ q ]
+// с постоянным блоком G решаются через дополнение Шура g - c^T * G^(-1) * c
+// (в случае успеха возвращается 0, ошибки - <0)
+static int rfpos_guess_sub(
+  rfpos_t *self, // структура данных компонента
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j, k;
+  double c[RFPOS_D_MAX], h[RFPOS_D_MAX], a[RFPOS_D_MAX], b[RFPOS_D_MAX];
+  double w[RFPOS_D_MAX], g = 0., q = 0., dr, den, d0;
+  const rfpos_sub_t *ps = self->sub;
+  la_float_t **y = self->y.d;
+
+  dr = y[d][0];
+  for (j = 0; j < d; j++)
+    c[j] = h[j] = 0.;
+
+  // накопить блоки, зависящие от временных меток
+  for (i = 1; i < n; i++)
+  {
+    double dd = y[d][i] - dr, bi = dr * dr - y[d][i] * y[d][i];
+    for (j = 0; j < d; j++)
+    {
+      w[j] = y[j][i] - y[j][0];
+      bi += w[j] * w[j];
+    }
+    for (j = 0; j < d; j++)
+    {
+      c[j] -= 4. * w[j] * dd;
+      h[j] += 2. * w[j] * bi;
+    }
+    g += 4. * dd * dd;
+    q -= 2. * dd * bi;
+  }
+
+  // a = G^(-1) * h, b = G^(-1) * c
+  den = g;
+  d0  = q;
+  for (j = 0; j < d; j++)
+  {
+    a[j] = b[j] = 0.;
+    for (k = 0; k < d; k++)
+    {
+      a[j] += ps->gi[j][k] * h[k];
+      b[j] += ps->gi[j][k] * c[k];
+    }
+  }
+  for (j = 0; j < d; j++)
+  {
+    den -= c[j] * b[j];
+    d0  -= c[j] * a[j];
+  }
+  if (!(den > RFPOS_SUB_EPS * g))
+    return -1; // вырожденная геометрия
+
+  d0 /= den;
+  for (j = 0; j < d; j++)
+    self->x.d[j] = a[j] - b[j] * d0 + y[j][0];
+  self->x.d[d] = d0;
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// линеаризованное решение в замкнутой форме (для n >= d + 2): уравнения
+// |X - S[i]|^2 = (d0 - d[i])^2 вычитаются из уравнения опорного приёмника r,
+// квадраты неизвестных сокращаются и остаётся линейная система
+//   2 (S[i] - S[r]) * X - 2 (d[i] - d[r]) * d0 =
+//     = |S[i] - S[r]|^2 - d[i]^2 + d[r]^2, i != r
+// относительно (X - S[r], d0), которая решается МНК однократно
+// (в случае успеха возвращается 0, ошибки - <0)
+static int rfpos_guess_lin(
+  rfpos_t *self, // структура данных компонента
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j, k, r = 0, u = d + 1;
+  double s[RFPOS_U_MAX][RFPOS_U_MAX], v[RFPOS_U_MAX], w[RFPOS_U_MAX];
+  double yr[RFPOS_U_MAX];
+  la_float_t **y = self->y.d;
+  la_float_t *cf = self->kc ? y[d + 1] : (la_float_t*) 0;
+  la_matrix_t an = self->ws.a;
+
+  if (n < d + 2) return -1; // система недоопределена
+
+  // постоянный блок подмножества уже обращён
+  if (self->sub && !cf && rfpos_guess_sub(self, d, n) == 0)
+    return 0;
 
-  // заполнить матрицу исходных данных
-  ptr = m;
+  // опорный приёмник - первым принявший сигнал (d[r] = 0)
+  for (i = 1; i < n; i++)
+    if (y[d][i] < y[d][r]) r = i;
+  for (j = 0; j < u; j++)
+    yr[j] = y[j][r];
+
+  for (j = 0; j < u; j++)
+  {
+    v[j] = 0.;
+    for (k = 0; k <= j; k++)
+      s[j][k] = 0.;
+  }
+
+  // накопить нормальные уравнения (координаты относительно S[r])
   for (i = 0; i < n; i++)
   {
+    double b = 0., q;
+    if (i == r) continue;
+
     for (j = 0; j < d; j++)
-      self->y.d[i][j] = *ptr++;
+    {
+      q = y[j][i] - yr[j];
+      w[j] = 2. * q;
+      b += q * q;
+    }
+    q = y[d][i];
+    w[d] = -2. * (q - yr[d]);
+    b += yr[d] * yr[d] - q * q;
+    if (cf) b += cf[i] - cf[r];
+
+    for (j = 0; j < u; j++)
+    {
+      q = w[j];
+      for (k = 0; k <= j; k++)
+        s[j][k] += q * w[k];
+      v[j] += q * b;
+    }
+  }
+
+  an.nrow = an.ncol = u;
+  for (j = 0; j < u; j++)
+  {
+    for (k = 0; k <= j; k++)
+      an.d[j][k] = s[j][k];
+    self->x.d[j] = v[j];
+  }
+
+  if (la_chol(&an) < 0)
+    return -2; // вырожденная геометрия
+  la_chol_solve(&an, &self->x);
 
-    self->y.d[i][d] = (t[i] - tmin) * RFPOS_C; // секунды -> метры
+  for (j = 0; j < d; j++)
+    self->x.d[j] += yr[j];
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// выбор исходной точки X = (x0, y0, z0, d0) итерационного поиска:
+// по предполагаемым координатам p, иначе линеаризованным решением
+// в замкнутой форме (n >= d + 2), иначе по центру масс приёмников
+static void rfpos_guess(
+  rfpos_t *self,   // структура данных компонента
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал
+  const double *p) // предполагаемые координаты передатчика [d] или NULL
+{
+  int i, j;
+  double d0;
+
+  if (p)
+  {
+    for (j = 0; j < d; j++)
+      self->x.d[j] = p[j];
+  }
+  else if (rfpos_guess_lin(self, d, n) == 0)
+  {
+    return; // d0 найдено вместе с координатами
+  }
+  else
+  { // центр масс приёмников
+    for (j = 0; j < d; j++)
+    {
+      double s = 0.;
+      for (i = 0; i < n; i++)
+        s += self->y.d[j][i];
+      self->x.d[j] = s / (double) n;
+    }
   }
-  
+
   // вычислить оценку d0 искомой точки
   d0 = 0.;
   for (i = 0; i < n; i++)
   {
-    double dd = 0.;
+    double dd = self->kc ? self->y.d[d + 1][i] : 0.;
     for (j = 0; j < d; j++)
     {
-      double q = p[j] - self->y.d[i][j];
+      double q = self->x.d[j] - self->y.d[j][i];
       dd += q * q;
     }
-    d0 += self->y.d[i][d] - sqrt(dd);
+    d0 += self->y.d[d][i] - sqrt(dd);
   }
   d0 /= (double) n;
+  self->x.d[d] = d0;
+}
+//----------------------------------------------------------------------------
+// скалярное произведение в метрике Минковского (d пространственных
+// координат и дальномерная координата с обратным знаком)
+static double rfpos_mink(int d, const double *a, const double *b)
+{
+  int j;
+  double s = -a[d] * b[d];
+  for (j = 0; j < d; j++)
+    s += a[j] * b[j];
+  return s;
+}
+//----------------------------------------------------------------------------
+// alpha = M^(-1) * 1 и beta = M^(-1) * c (см. rfpos_minimal()) для первых
+// d+1 столбцов self->y по данным подмножества self->sub без исключения
+// Гаусса: сумма строк P[i] = S[i] - Z равна нулю, поэтому из
+// P * X' - d * w = v следует w = -sum(v) / sum(d), X' = P^(+) * (v + d * w)
+// (в случае успеха возвращается 0, ошибки - <0)
+static int rfpos_minimal_sub(
+  rfpos_t *self,             // структура данных компонента
+  int d,                     // размерность координат (2 или 3)
+  double al[RFPOS_U_MAX],    // alpha
+  double be[RFPOS_U_MAX],    // beta
+  double z[RFPOS_U_MAX])     // центр масс приёмников (d0 не переносится)
+{
+  int i, j, u = d + 1;
+  double c[RFPOS_U_MAX], sd = 0., sc = 0., wa, wb;
+  const rfpos_sub_t *ps = self->sub;
+  const la_float_t *dd = self->y.d[d];
 
-  // заполнить исходную точку поиска решения
+  for (i = 0; i < u; i++)
+  {
+    c[i] = ps->ss[i] - dd[i] * dd[i]; // <A[i],A[i]>
+    sd += dd[i];
+    sc += c[i];
+  }
+  if (!(sd > 0.))
+    return -1; // все метки равны: M вырождена
+
+  wa = -(double) u / sd;
+  wb = -sc / sd;
   for (j = 0; j < d; j++)
-    self->x.d[j] = p[j];
-  self->x.d[d] = d0;
-  
-  // цикл итераций Ньютона
-  e *= e;
-  for (i = 0;; i++)
   {
-    int err;
-    double f, dx, q;
+    double qa = 0., qb = 0.;
+    for (i = 0; i < u; i++)
+    {
+      qa += ps->pp[j][i] * dd[i];
+      qb += ps->pp[j][i] * (c[i] + dd[i] * wb);
+    }
+    al[j] = qa * wa; // P^(+) * 1 = 0
+    be[j] = qb;
+    z[j]  = ps->z[j];
+  }
+  al[d] = wa;
+  be[d] = wb;
+  z[d]  = 0.;
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// решение в замкнутой форме для n = d + 1 приёмников (метод Бэнкрофта):
+// обозначим U = (X - Z, d0), A[i] = (S[i] - Z, d[i]), где Z - центр масс
+// приёмников (перенос улучшает обусловленность и не меняет уравнений),
+// тогда каждое уравнение имеет вид <U,U> - 2 <A[i],U> + <A[i],A[i]> = 0,
+// где <,> - произведение Минковского; при L = <U,U> линейная система
+// M * U = (L * 1 + c) / 2 даёт U = (L * alpha + beta) / 2, а подстановка
+// в L = <U,U> - квадратное уравнение относительно L
+// (возвращается число найденных решений 0...2; решения упорядочены
+// по правдоподобию, *amb = 1, если оба решения физически допустимы)
+static int rfpos_minimal(
+  rfpos_t *self,            // структура данных компонента
+  int d,                    // размерность координат (2 или 3)
+  const int *sub,           // номера d+1 столбцов self->y или NULL (первые)
+  double c[2][RFPOS_U_MAX], // решения (x0, y0, z0, d0)
+  int *amb)                 // признак неоднозначности
+{
+  static const int seq[RFPOS_U_MAX] = {0, 1, 2, 3}; // первые d+1 столбцов
+  int i, j, k, u = d + 1, cnt = 0, ok[2];
+  double al[RFPOS_U_MAX] = {0.}, be[RFPOS_U_MAX] = {0.}; // alpha, beta
+  double z[RFPOS_U_MAX], lam[2], A, B, C, D, q, dmin;
+  la_matrix_t g = self->g; // расширенная матрица [M | 1 | c]
+
+  g.nrow = u;
+  g.ncol = u + 2;
+  *amb = 0;
+
+  // самая ранняя временная метка подмножества
+  dmin = self->y.d[d][sub ? sub[0] : 0];
+  for (i = 1; i < u; i++)
+    if (dmin > self->y.d[d][sub ? sub[i] : i])
+      dmin = self->y.d[d][sub ? sub[i] : i];
+
+  // alpha и beta по данным подмножества, если они подготовлены
+  if (sub || !self->sub || self->kc || rfpos_minimal_sub(self, d, al, be, z))
+  {
+    if (!sub) sub = seq;
+
+    // центр масс приёмников (d0 не переносится)
+    for (j = 0; j < d; j++)
+    {
+      q = 0.;
+      for (i = 0; i < u; i++)
+        q += self->y.d[j][sub[i]];
+      z[j] = q / (double) u;
+    }
+    z[d] = 0.;
 
-    // вычислить "невязку"
-    rfpos_f(n, d, &self->x, &self->y, &self->f);
+    // заполнить расширенную матрицу: строки M[i] = (S[i] - Z, -d[i])
+    for (i = 0; i < u; i++)
+    {
+      double s = 0.;
+      for (j = 0; j < d; j++)
+      {
+        q = self->y.d[j][sub[i]] - z[j];
+        g.d[i][j] = q;
+        s += q * q;
+      }
+      q = self->y.d[d][sub[i]] - z[d];
+      g.d[i][d] = -q;
+      g.d[i][u]     = 1.;
+      g.d[i][u + 1] = s - q * q; // <A[i],A[i]>
+      if (self->kc)
+        g.d[i][u + 1] += self->y.d[d + 1][sub[i]]; // постоянное слагаемое
+    }
 
-    // оценить невязку по модулю
-    f = 0.;
-    for (j = 0; j <= d; j++)
+    // alpha = M^(-1) * 1, beta = M^(-1) * c
+    if (la_gauss(&g) < 0)
+      return 0; // вырожденная геометрия
+    for (j = 0; j < u; j++)
     {
-      q = self->f.d[j];
-      f += q * q;
+      al[j] = g.d[j][u];
+      be[j] = g.d[j][u + 1];
     }
+  }
+
+  // <alpha,alpha> * L^2 + (2 * <alpha,beta> - 4) * L + <beta,beta> = 0
+  A = rfpos_mink(d, al, al);
+  B = 2. * rfpos_mink(d, al, be) - 4.;
+  C = rfpos_mink(d, be, be);
+  D = B * B - 4. * A * C;
+  if (D < 0.) D = 0.; // кратный корень (с учётом шумов)
+  q = -0.5 * (B + (B < 0. ? -sqrt(D) : sqrt(D)));
+  if (A != 0.) lam[cnt++] = q / A;
+  if (q != 0. && (cnt == 0 || D > 0.)) lam[cnt++] = C / q;
+
+  // восстановить решения и проверить допустимость: d0 <= min(d[i]),
+  // т.е. сигнал излучён не позже, чем принят первым приёмником
+  for (k = 0; k < cnt; k++)
+  {
+    for (j = 0; j < u; j++)
+      c[k][j] = 0.5 * (lam[k] * al[j] + be[j]) + z[j];
+    ok[k] = isfinite(c[k][d]) && c[k][d] <= dmin + RFPOS_MIN_TOL;
+  }
+  if (cnt == 2)
+  {
+    // первым ставится допустимое решение, из двух допустимых - с большим
+    // d0 (передатчик ближе к приёмникам)
+    if ((!ok[0] && ok[1]) || (ok[0] && ok[1] && c[1][d] > c[0][d]))
+      for (j = 0; j < u; j++)
+      {
+        q = c[0][j];
+        c[0][j] = c[1][j];
+        c[1][j] = q;
+      }
+    *amb = ok[0] && ok[1];
+    if (!ok[0] || !ok[1]) cnt = 1; // недопустимое решение отбрасывается
+  }
+  if (cnt == 1 && !ok[0] && !isfinite(c[0][d]))
+    cnt = 0;
+
+  return cnt;
+}
+//----------------------------------------------------------------------------
+// монотонное время [с] (CLOCK_MONOTONIC) для задания срока решения
+double rfpos_time(void)
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return ((double) tv.tv_sec) + ((double) tv.tv_nsec) * 1e-9;
+}
+//----------------------------------------------------------------------------
+// проверить срок решения импульса (1 - срок задан и истёк)
+static int rfpos_late(const rfpos_t *self)
+{
+  return self->tdl > 0. && rfpos_time() > self->tdl;
+}
+//----------------------------------------------------------------------------
+// запомнить приближение self->x с квадратом модуля невязки f, если оно
+// лучше запомненного (при заданном сроке решения), и проверить срок; по
+// истечении срока в self->x возвращается лучшее приближение
+// (возвращается 1, если срок истёк)
+static int rfpos_best(
+  rfpos_t *self, // структура данных компонента
+  int d,         // размерность координат (2 или 3)
+  double f,      // квадрат модуля невязки в точке self->x
+  double *fb,    // квадрат модуля невязки лучшего приближения
+  double *xb)    // лучшее приближение [d+1]
+{
+  int j;
+
+  if (self->tdl <= 0.)
+    return 0; // срок не задан
+
+  if (f < *fb)
+  {
+    *fb = f;
+    for (j = 0; j <= d; j++)
+      xb[j] = self->x.d[j];
+  }
+
+  if (rfpos_time() <= self->tdl)
+    return 0;
+
+  if (*fb < f)
+  { // последний шаг увеличил невязку - вернуть лучшее приближение
+    for (j = 0; j <= d; j++)
+      self->x.d[j] = xb[j];
+    self->fa = RFPOS_FA_NONE;
+  }
+  return 1;
+}
+//----------------------------------------------------------------------------
+// итерации Гаусса-Ньютона (x -= dx) из исходной точки self->x
+// (возвращается число выполненных итераций или отрицательный код ошибки)
+// итерации прекращаются успешно, если:
+//  - квадрат модуля невязки по всем n приёмникам не более e^2;
+//  - невязка перестала уменьшаться (относительное улучшение не более
+//    RFPOS_REL_TOL - достигнут уровень шумов измерений);
+//  - модуль поправки dx не более e
+// по истечении срока self->tdl возвращается RFPOS_ERR_TIME (в self->x -
+// приближение с наименьшей невязкой)
+static int rfpos_solve_gn(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j;
+  double f, fp = 0., s, q, fb = HUGE_VAL, xb[RFPOS_U_MAX];
+  la_matrix_t an  = self->ws.a; // используются только первые d+1 строк
+  la_vector_t dxn = self->dx;   // и первые d+1 неизвестных
+  an.nrow = an.ncol = dxn.size = d + 1;
+
+  e *= e;
+  for (i = 0;; i++)
+  {
+    // вычислить невязку и нормальные уравнения за один проход
+    RFPOS_STAT_T(t1);
+    f = rfpos_fw(self, n, d, &an, &dxn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+    self->fa = RFPOS_FA_RAW;
     if (f <= e)
-      break; // успех: достигнута требуемая точность
+      return i; // успех: невязка мала
 
-    // проверить лимит итераций
+    if (i > 0 && f <= fp && fp - f <= RFPOS_REL_TOL * fp)
+      return i; // успех: невязка перестала уменьшаться
+
+    // проверить срок решения и лимит итераций
+    if (rfpos_best(self, d, f, &fb, xb))
+      return RFPOS_ERR_TIME; // истёк срок решения
     if (i >= it)
-      break; // превышен лимит итераций
-  
-    // вычислить матрицу Якоби
-    rfpos_w(n, d, &self->x, &self->y, &self->w);
-      
-    // решить систему линейных уравнений
-    self->dx = la_svd_simple(&self->w, &self->f, &err);
-    if (err < 0)
-      break; // ошибка решения ?! Почему? FIXME
-
-    // отладочная печать модуля f и dx FIXME
-    dx = 0.;  
-    for (j = 0; j <= d; j++)
+      return RFPOS_ERR_IT; // превышен лимит итераций
+
+    // решить нормальные уравнения (W^(T) * W) * dx = W^(T) * F
+    RFPOS_STAT_T(t2);
+    self->fa = RFPOS_FA_NONE;
+    if (la_chol(&an) < 0)
+      return RFPOS_ERR_SING; // вырожденная геометрия
+    la_chol_solve(&an, &dxn);
+    self->fa = RFPOS_FA_CHOL;
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+
+    // выполнить коррекцию: x -= dx
+    for (j = 0, s = 0.; j <= d; j++)
     {
-      q = self->dx.d[j];
-      dx += q * q;
+      q = dxn.d[j];
+      self->x.d[j] -= q;
+      s += q * q;
     }
-    printf(">>> mod(f)=%g => mod(dx)=%g\n", sqrt(f), sqrt(dx));
-    
-    // выполнить коррекцию: x -= dx
-    for (j = 0; j <= d; j++)
-      self->x.d[j] -= self->dx.d[j];
 
-    la_vector_free(&self->dx);
+    RFPOS_STAT_STEP(self, f, s); // история модулей f и dx
+
+    if (s <= e)
+      return i + 1; // успех: поправка меньше требуемой точности
+    fp = f;
+  }
+}
+//----------------------------------------------------------------------------
+// изменить разложение Холецкого L нормальной матрицы B = L * L^(T) по
+// формуле BFGS: B + y * y^(T) / (y^(T) * s) - (B * s) * (B * s)^(T) /
+// (s^(T) * B * s), где s = -dx - последний шаг, y = g - gp - изменение
+// вектора W^(T) * F (два изменения ранга 1 la_chol_update(), O(d^2))
+// (в случае успеха возвращается 0, иначе -1 - разложение нужно построить
+// заново)
+static int rfpos_bfgs(
+  rfpos_t *self,       // структура данных компонента
+  int d,               // размерность задачи
+  la_matrix_t *l,      // разложение L [d+1][d+1]
+  const double *dx,    // последняя поправка (x -= dx) [d+1]
+  const double *gp,    // вектор W^(T) * F до шага [d+1]
+  const la_vector_t *g) // вектор W^(T) * F после шага [d+1]
+{
+  int j, k, u = d + 1;
+  double v[RFPOS_U_MAX], bs[RFPOS_U_MAX], ys = 0., sbs = 0., q;
+  la_vector_t vn = self->ub; // рабочий вектор
+  vn.size = u;
+
+  // y^(T) * s и B * s = L * (L^(T) * s) (со знаком минус)
+  for (j = 0; j < u; j++)
+  {
+    ys -= (g->d[j] - gp[j]) * dx[j];
+    for (k = j, v[j] = 0.; k < u; k++)
+      v[j] += l->d[k][j] * dx[k];
+    sbs += v[j] * v[j];
   }
+  for (j = 0; j < u; j++)
+    for (k = 0, bs[j] = 0.; k <= j; k++)
+      bs[j] += l->d[j][k] * v[k];
+  if (!(ys > 0.) || !(sbs > 0.))
+    return -1; // кривизна вдоль шага не положительна
 
-  // заполнить выходные данные
-  *t0 = self->x.d[d] / RFPOS_C + tmin;
-  for (j = 0; j < d; j++)
-    r[j] = self->x.d[j];
+  q = 1. / sqrt(ys);
+  for (j = 0; j < u; j++)
+    vn.d[j] = (g->d[j] - gp[j]) * q;
+  if (la_chol_update(l, &vn, 1) < 0)
+    return -1;
+
+  q = 1. / sqrt(sbs);
+  for (j = 0; j < u; j++)
+    vn.d[j] = bs[j] * q;
+  return la_chol_update(l, &vn, -1) < 0 ? -1 : 0;
+}
+//----------------------------------------------------------------------------
+// квазиньютоновские итерации (режим RFPOS_OPT_CHORD): разложение
+// Холецкого нормальной матрицы W^(T) * W сохраняется между итерациями и
+// уточняется по формуле BFGS (rfpos_bfgs()), а проход по приёмникам
+// вычисляет только вектор W^(T) * F в текущей точке (O(n * d) вместо
+// O(n * d^2 + d^3)); матрица строится и раскладывается заново только на
+// первой итерации и затем, если модуль W^(T) * F уменьшился меньше, чем в
+// 1/RFPOS_CHORD_RHO раз, если шаг увеличил невязку (шаг со старым
+// разложением при этом отменяется) и если уточнение BFGS невозможно; число
+// итераций без построения матрицы - в поле nc; решение
+// совпадает с решением rfpos_solve_gn() (в нём W^(T) * F обращается в
+// ноль), критерии остановки и срок решения - те же
+static int rfpos_solve_ch(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j, rf = 1, ch = 0; // rf = 1 - построить нормальную матрицу заново,
+                            // ch = 1 - шаг сделан со старым разложением
+  double f, fp = 0., s, g, gq = 0., q, fb = HUGE_VAL, xb[RFPOS_U_MAX];
+  double xp[RFPOS_U_MAX], gp[RFPOS_U_MAX]; // последние поправка и W^(T) * F
+  la_matrix_t an  = self->ws.a; // используются только первые d+1 строк
+  la_vector_t dxn = self->dx;   // и первые d+1 неизвестных
+  an.nrow = an.ncol = dxn.size = d + 1;
+
+  e *= e;
+  self->nc = 0;
+  for (i = 0;; i++)
+  {
+    // вычислить невязку и W^(T) * F (при rf - и нормальную матрицу)
+    RFPOS_STAT_T(t1);
+    if (!rf)
+    {
+      f = rfpos_gr(self, n, d, &dxn);
+      self->fa = RFPOS_FA_NONE; // ws.a - не разложение в этой точке
+      for (j = 0, g = 0.; j <= d; j++)
+        g += dxn.d[j] * dxn.d[j];
+      if (f > fp)
+      { // шаг увеличил невязку - построить матрицу заново; шаг со старым
+        // разложением отменяется, и из прошлой точки выполняется шаг
+        // Гаусса-Ньютона
+        if (ch)
+        {
+          for (j = 0; j <= d; j++)
+            self->x.d[j] += xp[j];
+          fp = 0.; // в прошлой точке невязка не проверяется повторно
+        }
+        rf = 1;
+      }
+      else if (f > e && fp - f > RFPOS_REL_TOL * fp && // итерации не кончены
+               (g > RFPOS_CHORD_RHO * RFPOS_CHORD_RHO * gq ||
+                rfpos_bfgs(self, d, &an, xp, gp, &dxn) < 0))
+        rf = 1; // медленная сходимость или уточнение BFGS невозможно
+      else
+        self->nc++; // итерация без построения нормальной матрицы
+    }
+    if (rf)
+    {
+      f = rfpos_fw(self, n, d, &an, &dxn);
+      self->fa = RFPOS_FA_RAW;
+    }
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+    if (f <= e)
+      return i; // успех: невязка мала
+
+    if (i > 0 && f <= fp && fp - f <= RFPOS_REL_TOL * fp)
+      return i; // успех: невязка перестала уменьшаться
+
+    // проверить срок решения и лимит итераций
+    if (rfpos_best(self, d, f, &fb, xb))
+      return RFPOS_ERR_TIME; // истёк срок решения
+    if (i >= it)
+      return RFPOS_ERR_IT; // превышен лимит итераций
+
+    // решить (W^(T) * W) * dx = W^(T) * F (при rf - с новым разложением)
+    RFPOS_STAT_T(t2);
+    for (j = 0, gq = 0.; j <= d; j++)
+    {
+      q = gp[j] = dxn.d[j];
+      gq += q * q;
+    }
+    ch = !rf;
+    if (rf)
+    {
+      if (la_chol(&an) < 0)
+      {
+        self->fa = RFPOS_FA_NONE;
+        return RFPOS_ERR_SING; // вырожденная геометрия
+      }
+      self->fa = RFPOS_FA_CHOL;
+    }
+    la_chol_solve(&an, &dxn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+
+    // выполнить коррекцию: x -= dx
+    for (j = 0, s = 0.; j <= d; j++)
+    {
+      q = xp[j] = dxn.d[j];
+      self->x.d[j] -= q;
+      s += q * q;
+    }
+
+    RFPOS_STAT_STEP(self, f, s); // история модулей f и dx
+
+    if (s <= e)
+      return i + 1; // успех: поправка меньше требуемой точности
+
+    rf = 0; // разложение сохраняется
+    fp = f;
+  }
+}
+//----------------------------------------------------------------------------
+// итерации Гаусса-Ньютона (режим RFPOS_OPT_QR): система W(X,Y) * dx = F(X,Y)
+// решается отражениями Хаусхолдера la_qr_solve() без построения
+// W^(T) * W, поэтому число обусловленности не возводится в квадрат
+// (полезно при плохой геометрии и при сборке с LA_FLOAT)
+// (возвращается число выполненных итераций или отрицательный код ошибки,
+// критерии остановки и срок решения - как у rfpos_solve_gn())
+static int rfpos_solve_qr(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j;
+  double f, fp = 0., s, q, fb = HUGE_VAL, xb[RFPOS_U_MAX];
+  la_matrix_t wn  = self->wq; // используются первые n строк
+  la_vector_t fn  = self->fq;
+  la_vector_t dxn = self->dx;
+  wn.nrow = fn.size = n;
+  wn.ncol = dxn.size = d + 1;
+
+  self->fa = RFPOS_FA_NONE; // нормальная матрица не строится
+  e *= e;
+  for (i = 0;; i++)
+  {
+    RFPOS_STAT_T(t1);
+    f = rfpos_wf(self, n, d, &wn, &fn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+    if (f <= e)
+      return i; // успех: невязка мала
+
+    if (i > 0 && f <= fp && fp - f <= RFPOS_REL_TOL * fp)
+      return i; // успех: невязка перестала уменьшаться
+
+    if (rfpos_best(self, d, f, &fb, xb))
+      return RFPOS_ERR_TIME; // истёк срок решения
+    if (i >= it)
+      return RFPOS_ERR_IT; // превышен лимит итераций
+
+    RFPOS_STAT_T(t2);
+    if (la_qr_solve(&wn, &fn, &dxn) < 0)
+      return RFPOS_ERR_SING; // вырожденная геометрия
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+
+    for (j = 0, s = 0.; j <= d; j++)
+    {
+      q = dxn.d[j];
+      self->x.d[j] -= q;
+      s += q * q;
+    }
+
+    RFPOS_STAT_STEP(self, f, s);
+
+    if (s <= e)
+      return i + 1; // успех: поправка меньше требуемой точности
+    fp = f;
+  }
+}
+//----------------------------------------------------------------------------
+// итерации Гаусса-Ньютона по разностям дальностей (режим RFPOS_OPT_TDOA):
+// невязки e[i] = |X - S[i]| + d0 - d[i] линейны по d0, поэтому d0 на каждой
+// итерации исключается из нормальных уравнений (дополнение Шура по
+// строке (u, 1)), и решается система d x d только по координатам X;
+// это тот же обобщённый МНК, что и для разностей относительно опорного
+// приёмника с их корреляционной матрицей diag(s[i]^2) + s[0]^2 * 1 * 1^(T)
+// (la_svd_full()), но без построения и обращения матрицы n x n; d0
+// (и t0) восстанавливается по найденной точке
+// (возвращается число выполненных итераций или отрицательный код ошибки,
+// критерии остановки и срок решения - как у rfpos_solve_gn(), невязка -
+// по дальности, а не по квадратам дальностей)
+static int rfpos_solve_td(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j, k, l, o = d * (d + 1) / 2;
+  double a[RFPOS_U_MAX * (RFPOS_U_MAX + 1) / 2], v[RFPOS_U_MAX];
+  double f, fp = 0., s, q, c, fb = HUGE_VAL, xb[RFPOS_U_MAX];
+  la_matrix_t an  = self->ws.a; // используются только первые d строк
+  la_vector_t dxn = self->dx;   // и первые d неизвестных
+  an.nrow = an.ncol = dxn.size = d;
+
+  self->fa = RFPOS_FA_NONE; // ws.a содержит систему без d0
+  e *= e;
+  for (i = 0;; i++)
+  {
+    // суммы по строкам (u, 1) за один проход (a[o...o+d] - последняя
+    // строка: sum(c * u), sum(c); v[d] = sum(c * e))
+    RFPOS_STAT_T(t1);
+    f = self->td[d](n, self->x.d, self->y.d, self->wt ? self->sw.d : NULL,
+                    self->kc ? self->y.d[d + 1] : NULL, a, v);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+
+    // исключить d0: d0 = -sum(c * e) / sum(c), A - g * g^(T) / sum(c),
+    // B - g * sum(c * e) / sum(c), где g = sum(c * u)
+    c = 1. / a[o + d];
+    self->x.d[d] = -v[d] * c;
+    f -= v[d] * v[d] * c;
+    for (j = 0, l = 0; j < d; j++)
+    {
+      q = a[o + j] * c;
+      for (k = 0; k <= j; k++, l++)
+        an.d[j][k] = a[l] - q * a[o + k];
+      dxn.d[j] = v[j] - q * v[d];
+    }
+
+    if (f <= e)
+      return i; // успех: невязка мала
+
+    if (i > 0 && f <= fp && fp - f <= RFPOS_REL_TOL * fp)
+      return i; // успех: невязка перестала уменьшаться
+
+    if (rfpos_best(self, d, f, &fb, xb))
+      return RFPOS_ERR_TIME; // истёк срок решения
+    if (i >= it)
+      return RFPOS_ERR_IT; // превышен лимит итераций
+
+    RFPOS_STAT_T(t2);
+    if (la_chol(&an) < 0)
+      return RFPOS_ERR_SING; // вырожденная геометрия
+    la_chol_solve(&an, &dxn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+
+    // выполнить коррекцию x -= dx и восстановить d0 в новой точке
+    // (обратная подстановка исключённой неизвестной)
+    for (j = 0, s = 0.; j < d; j++)
+    {
+      q = dxn.d[j];
+      self->x.d[j] -= q;
+      self->x.d[d] += a[o + j] * c * q;
+      s += q * q;
+    }
+
+    RFPOS_STAT_STEP(self, f, s);
+
+    if (s <= e)
+      return i + 1; // успех: поправка меньше требуемой точности
+    fp = f;
+  }
+}
+//----------------------------------------------------------------------------
+// итерации Левенберга-Марквардта из исходной точки self->x: решается
+// (W^(T) * W + mu * I) * dx = W^(T) * F, пробный шаг
+// принимается, только если невязка уменьшилась; mu уменьшается после
+// удачных шагов (по отношению фактического и предсказанного уменьшения
+// невязки) и растёт после неудачных, поэтому при плохой геометрии
+// итерации не "раскачиваются"; каждый пробный шаг считается итерацией
+// (возвращается число выполненных итераций или отрицательный код ошибки,
+// критерии остановки и срок решения - как у rfpos_solve_gn())
+static int rfpos_solve_lm(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i = 0, j, k, u = d + 1;
+  double a0[RFPOS_U_MAX][RFPOS_U_MAX], b0[RFPOS_U_MAX], xt[RFPOS_U_MAX];
+  double f, ft, s, q, pr, rho, mu = RFPOS_LM_MU, nu = 2.;
+  la_matrix_t an  = self->ws.a;
+  la_vector_t dxn = self->dx;
+  an.nrow = an.ncol = dxn.size = u;
+
+  e *= e;
+  RFPOS_STAT_T(t1);
+  f = rfpos_fw(self, n, d, &an, &dxn);
+  RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+  self->fa = RFPOS_FA_NONE; // ws.a содержит демпфированную матрицу
+
+  // начальное mu - относительно наибольшего диагонального элемента
+  for (j = 0, q = 0.; j < u; j++)
+    if (q < an.d[j][j]) q = an.d[j][j];
+  mu *= q;
+
+  for (;;)
+  {
+    if (f <= e)
+      return i; // успех: невязка мала
+
+    // сохранить нормальные уравнения без демпфирования
+    for (j = 0; j < u; j++)
+    {
+      for (k = 0; k <= j; k++)
+        a0[j][k] = an.d[j][k];
+      b0[j] = dxn.d[j];
+    }
+
+    // подбор mu до первого удачного шага
+    for (;;)
+    {
+      if (rfpos_late(self))
+        return RFPOS_ERR_TIME; // истёк срок (self->x - лучшее приближение)
+      if (i >= it)
+        return RFPOS_ERR_IT; // превышен лимит итераций
+      i++;
+
+      for (j = 0; j < u; j++)
+      {
+        for (k = 0; k <= j; k++)
+          an.d[j][k] = a0[j][k];
+        an.d[j][j] += mu;
+        dxn.d[j] = b0[j];
+      }
+
+      rho = -1.;
+      s = 0.;
+      RFPOS_STAT_T(t2);
+      if (la_chol(&an) >= 0)
+      {
+        la_chol_solve(&an, &dxn);
+        RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+
+        // пробная точка и предсказанное уменьшение невязки
+        // |F|^2 - |F - W * dx|^2 = dx^(T) * (b + mu * dx)
+        for (j = 0, pr = 0.; j < u; j++)
+        {
+          q = dxn.d[j];
+          xt[j] = self->x.d[j] - q;
+          pr += q * (b0[j] + mu * q);
+          s += q * q;
+        }
+        RFPOS_STAT_T(t3);
+        ft = rfpos_f(n, d, xt, self->y.d, self->wt ? self->sw.d : NULL,
+                     self->kc ? self->y.d[d + 1] : NULL);
+        RFPOS_STAT_PHASE(self, RFPOS_STAT_F, t3);
+        if (pr > 0.)
+          rho = (f - ft) / pr;
+
+        RFPOS_STAT_STEP(self, f, s);
+
+        if (rho > 0.)
+          break; // удачный шаг
+
+        if (s <= e)
+          return i; // успех: даже малый шаг не уменьшает невязку
+      }
+
+      // неудачный шаг: увеличить демпфирование
+      mu *= nu;
+      nu *= 2.;
+    }
+
+    // принять шаг, уменьшить демпфирование
+    for (j = 0; j < u; j++)
+      self->x.d[j] = xt[j];
+    q = 2. * rho - 1.;
+    q = 1. - q * q * q;
+    mu *= q > 1. / 3. ? q : 1. / 3.;
+    nu = 2.;
+
+    if (s <= e)
+      return i; // успех: поправка меньше требуемой точности
+
+    if (f - ft <= RFPOS_REL_TOL * f)
+      return i; // успех: невязка перестала уменьшаться
+
+    RFPOS_STAT_T(t4);
+    f = rfpos_fw(self, n, d, &an, &dxn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t4);
+  }
+}
+//----------------------------------------------------------------------------
+// итерации Гаусса-Ньютона одинарной точности (режим RFPOS_OPT_F32) из
+// исходной точки self->x: столбцы self->y переносятся в float относительно
+// первого приёмника (координаты площадки малы, поэтому float хватает для
+// приближения с точностью порядка 10^-5 м), поправки ищутся ядром
+// `rfpos_fwf_t` (вдвое больше приёмников за команду), пока модуль поправки
+// больше e или, начиная с RFPOS_F32_E, быстро уменьшается; завершающую
+// итерацию (обычно одну) выполняет rfpos_solve_gn() в double
+// (возвращается число выполненных итераций; при расходимости self->x
+// возвращается к исходной точке)
+static int rfpos_solve_f32(
+  rfpos_t *self, // структура данных компонента
+  int it,        // максимальное число итераций
+  double e,      // желаемая численная точность оценки координат [м]
+  int d,         // размерность координат (2 или 3)
+  int n)         // число приёмников, принявших сигнал
+{
+  int i, j, k, l, u = d + 1;
+  double o[RFPOS_U_MAX], x[RFPOS_U_MAX], s[RFPOS_U_MAX * (RFPOS_U_MAX + 1) / 2];
+  double v[RFPOS_U_MAX], f, q, qp = 0.;
+  float **yf = self->yf;
+  la_float_t **y = self->y.d;
+  la_matrix_t an  = self->ws.a;
+  la_vector_t dxn = self->dx;
+  an.nrow = an.ncol = dxn.size = u;
+
+  e *= e;
+
+  // начало координат - первый приёмник (дальности не переносятся)
+  for (j = 0; j < u; j++)
+  {
+    o[j] = j < d ? y[j][0] : 0.;
+    for (i = 0; i < n; i++)
+      yf[j][i] = (float) (y[j][i] - o[j]);
+    x[j] = self->x.d[j] - o[j];
+  }
+  for (i = 0; self->kc && i < n; i++)
+    yf[u][i] = (float) y[u][i];
+  for (i = 0; self->wt && i < n; i++)
+    self->swf[i] = (float) self->sw.d[i];
+
+  for (i = 0; i < it && !rfpos_late(self);)
+  {
+    RFPOS_STAT_T(t1);
+    f = self->fwf[d](n, x, yf, self->wt ? self->swf : NULL,
+                     self->kc ? yf[u] : NULL, s, v);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_FW, t1);
+    for (j = 0, l = 0; j < u; j++)
+    {
+      for (k = 0; k <= j; k++, l++)
+        an.d[j][k] = s[l];
+      dxn.d[j] = v[j];
+    }
+    RFPOS_STAT_T(t2);
+    if (la_chol(&an) < 0)
+      break; // вырожденность обнаружит rfpos_solve_gn()
+    la_chol_solve(&an, &dxn);
+    RFPOS_STAT_PHASE(self, RFPOS_STAT_LIN, t2);
+    i++;
+
+    for (j = 0, q = 0.; j < u; j++)
+    {
+      x[j] -= dxn.d[j];
+      q += dxn.d[j] * dxn.d[j];
+    }
+
+    RFPOS_STAT_STEP(self, f, q); // история модулей f и dx
+    if (!isfinite(q))
+      return i; // расходимость: продолжить в double из исходной точки
+
+    // поправка меньше требуемой точности или (начиная с RFPOS_F32_E)
+    // перестала быстро уменьшаться - достигнут предел точности float
+    if (q <= e || (q <= RFPOS_F32_E * RFPOS_F32_E && q > 0.0625 * qp))
+      break;
+    qp = q;
+  }
+
+  for (j = 0; j < u; j++)
+    self->x.d[j] = x[j] + o[j];
+  self->fa = RFPOS_FA_NONE;
+
+  return i;
+}
+//----------------------------------------------------------------------------
+// итерационное решение системы для загруженной матрицы self->y
+// (p - предполагаемые координаты передатчика или NULL, см. rfpos_guess())
+static int rfpos_solve(
+  rfpos_t *self,   // структура данных компонента
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал
+  const double *p, // радиус вектор предполагаемого нахождения передатчика [d]
+  double *t0,      // оценка времени излучения сигнала передатчиком
+  double *r)       // радиус вектор передатчика [d]
+{
+  int j, retv;
+
+  RFPOS_STAT_BEGIN(self);
+
+  // при n = d + 1 решение находится в замкнутой форме без итераций
+  if (n == d + 1)
+  {
+    int amb, k = 0;
+    double c[2][RFPOS_U_MAX];
+
+    if (rfpos_minimal(self, d, (const int*) 0, c, &amb) > 0)
+    {
+      // из двух допустимых решений выбрать ближайшее к p
+      if (amb && p)
+      {
+        double s0 = 0., s1 = 0., q;
+        for (j = 0; j < d; j++)
+        {
+          q = c[0][j] - p[j]; s0 += q * q;
+          q = c[1][j] - p[j]; s1 += q * q;
+        }
+        if (s1 < s0) k = 1;
+      }
+
+      *t0 = c[k][d] / RFPOS_C + self->tmin;
+      for (j = 0; j < d; j++)
+        r[j] = self->x.d[j] = c[k][j];
+      self->x.d[d] = c[k][d];
+      self->uc = self->kc ? RFPOS_UC_NONE : RFPOS_UC_X;
+      self->sv = 1;
+
+      RFPOS_STAT_END(self, 0);
+      return 0; // итерации не выполнялись
+    }
+  }
+
+  // выбрать исходную точку поиска решения
+  rfpos_guess(self, d, n, p);
+
+  if (self->opt & RFPOS_OPT_TDOA)
+    retv = rfpos_solve_td(self, it, e, d, n);
+  else if (self->opt & RFPOS_OPT_LM)
+    retv = rfpos_solve_lm(self, it, e, d, n);
+  else if (self->opt & RFPOS_OPT_QR)
+    retv = rfpos_solve_qr(self, it, e, d, n);
+  else
+  { // в режиме RFPOS_OPT_F32 - сначала итерации одинарной точности
+    // (не менее двух итераций остаётся для уточнения в double)
+    j = (self->opt & RFPOS_OPT_F32) && self->fb && it > 2 ?
+        rfpos_solve_f32(self, it - 2, e, d, n) : 0;
+    retv = (self->opt & RFPOS_OPT_CHORD) ?
+           rfpos_solve_ch(self, it - j, e, d, n) :
+           rfpos_solve_gn(self, it - j, e, d, n);
+    if (retv >= 0) retv += j;
+  }
+  RFPOS_STAT_END(self, retv);
+  self->uc = retv >= 0 && !self->kc ? RFPOS_UC_X : RFPOS_UC_NONE;
+  self->sv = retv >= 0;
+
+  // заполнить выходные данные (при ошибке - последнее приближение)
+  *t0 = self->x.d[d] / RFPOS_C + self->tmin;
+  for (j = 0; j < d; j++)
+    r[j] = self->x.d[j];
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// основная функция для численного решения системы квадратных уравнений
+// (в случае ошибки возвращается отрицательный код ошибки,
+// в случае успеха - число выполненных итераций)
+// координаты передаются и возвращаются в метрах, время в секундах
+int rfpos_calc(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат или число неизвестных (2 или 3)
+  int n,           // число приёмников, принявших задержанный сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *p, // радиус вектор предполагаемого нахождения приёмника [d]
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор приёмника, если решение найдено [d]
+{
+  if (n > self->n) return RFPOS_ERR_N; // ошибка
+  if (d > self->d) return RFPOS_ERR_D; // ошибка
+
+  rfpos_load(self, d, n, m, (const int*) 0, t, (const double*) 0);
+  return rfpos_solve(self, it, e, d, n, p, t0, r);
+}
+//----------------------------------------------------------------------------
+// взвешенный вариант rfpos_calc(): каждый приёмник задаёт СКО своей
+// временной метки (по отношению сигнал/шум или качеству часов)
+int rfpos_calc_w(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] (s[i] > 0) или NULL [с]
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  if (n > self->n) return RFPOS_ERR_N; // ошибка
+  if (d > self->d) return RFPOS_ERR_D; // ошибка
+
+  rfpos_load(self, d, n, m, (const int*) 0, t, s);
+  return rfpos_solve(self, it, e, d, n, p, t0, r);
+}
+//----------------------------------------------------------------------------
+// заполнить данные подмножества приёмников (см. `rfpos_sub_t`)
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки;
+// для вырожденной геометрии возвращается 0 и sub->ok = 0)
+int rfpos_sub_init(
+  rfpos_sub_t *sub, // данные подмножества
+  int d,            // размерность координат (2 или 3)
+  int n,            // число приёмников подмножества (n > d)
+  const double *m,  // матрица координат приёмников [][d]
+  const int *idx)   // индексы приёмников в матрице m [n] или NULL
+{
+  int i, j, k;
+  double a[RFPOS_D_MAX][RFPOS_D_MAX], ai[RFPOS_D_MAX][RFPOS_D_MAX];
+  double w[RFPOS_D_MAX], q;
+  const double *s0, *ptr;
+
+  if (d < 2 || d > RFPOS_D_MAX) return RFPOS_ERR_D; // ошибка
+  if (n <= d) return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+
+  sub->d  = d;
+  sub->n  = n;
+  sub->ok = 0;
+
+  for (j = 0; j < d; j++)
+    for (k = 0; k < d; k++)
+      a[j][k] = 0.;
+
+  if (n == d + 1)
+  { // центр масс Z, |S[i] - Z|^2 и P^(T) * P
+    for (j = 0; j < d; j++)
+    {
+      q = 0.;
+      for (i = 0; i < n; i++)
+        q += m[(idx ? idx[i] : i) * d + j];
+      sub->z[j] = q / (double) n;
+    }
+    for (i = 0; i < n; i++)
+    {
+      ptr = m + (idx ? idx[i] : i) * d;
+      sub->ss[i] = 0.;
+      for (j = 0; j < d; j++)
+      {
+        w[j] = ptr[j] - sub->z[j];
+        sub->ss[i] += w[j] * w[j];
+      }
+      for (j = 0; j < d; j++)
+        for (k = 0; k < d; k++)
+          a[j][k] += w[j] * w[k];
+    }
+  }
+  else
+  { // 4 * sum(dS[i] * dS[i]^(T)) относительно первого приёмника
+    s0 = m + (idx ? idx[0] : 0) * d;
+    for (i = 1; i < n; i++)
+    {
+      ptr = m + (idx ? idx[i] : i) * d;
+      for (j = 0; j < d; j++)
+        w[j] = ptr[j] - s0[j];
+      for (j = 0; j < d; j++)
+        for (k = 0; k < d; k++)
+          a[j][k] += 4. * w[j] * w[k];
+    }
+  }
+
+  if (rfpos_inv_sym(d, a, ai) < 0)
+    return 0; // вырожденная геометрия: данные не используются
+
+  if (n == d + 1)
+  { // P^(+) = (P^(T) * P)^(-1) * P^(T)
+    for (i = 0; i < n; i++)
+    {
+      ptr = m + (idx ? idx[i] : i) * d;
+      for (j = 0; j < d; j++)
+      {
+        q = 0.;
+        for (k = 0; k < d; k++)
+          q += ai[j][k] * (ptr[k] - sub->z[k]);
+        sub->pp[j][i] = q;
+      }
+    }
+  }
+  else
+  {
+    for (j = 0; j < d; j++)
+      for (k = 0; k < d; k++)
+        sub->gi[j][k] = ai[j][k];
+  }
+
+  sub->ok = 1;
+  return 0;
+}
+//----------------------------------------------------------------------------
+// rfpos_calc_w() для импульса с заранее подготовленными данными
+// подмножества приёмников (коды возврата как у rfpos_calc())
+int rfpos_calc_sub(
+  rfpos_t *self,          // структура данных компонента
+  const rfpos_sub_t *sub, // данные подмножества приёмников или NULL
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [][d]
+  const int *idx,  // индексы приёмников в матрице m [n] или NULL
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] или NULL
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  int retv;
+
+  if (n > self->n) return RFPOS_ERR_N; // ошибка
+  if (d > self->d) return RFPOS_ERR_D; // ошибка
+  if (n <= d) return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+
+  rfpos_load(self, d, n, m, idx, t, s);
+
+  if (sub && sub->ok && sub->d == d && sub->n == n)
+    self->sub = sub;
+  retv = rfpos_solve(self, it, e, d, n, p, t0, r);
+  self->sub = (const rfpos_sub_t*) 0;
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// генератор псевдослучайных чисел xorshift32 (для выбора подмножеств)
+static unsigned rfpos_rand(unsigned *rs)
+{
+  unsigned x = *rs;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *rs = x;
+}
+//----------------------------------------------------------------------------
+// робастный вариант rfpos_calc() для измерений с выбросами (RANSAC)
+// (в случае ошибки возвращается отрицательный код ошибки,
+// в случае успеха - число выполненных итераций по "своим" приёмникам;
+// если "своих" приёмников меньше d+1, возвращается RFPOS_ERR_FEW)
+int rfpos_calc_ransac(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  double thr,      // порог невязки по дальности "своих" приёмников [м]
+  int hyp,         // максимальное число гипотез (<= 0 - RFPOS_RANSAC_HYP)
+  // на выходе:
+  double *t0,        // оценка времени излучения сигнала передатчиком
+  double *r,         // радиус вектор передатчика [d]
+  unsigned char *in) // признаки "своих" приёмников [n] или NULL
+{
+  int i, j, k, h, u = d + 1, all, amb, cnt, ni, nb = -1, need, retv;
+  int sub[RFPOS_U_MAX];
+  double c[2][RFPOS_U_MAX], xb[RFPOS_U_MAX], cs, best = 0., q, w;
+
+  if (n > self->n) return RFPOS_ERR_N; // ошибка
+  if (d > self->d) return RFPOS_ERR_D; // ошибка
+  if (n <= d) return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+  if (hyp <= 0) hyp = RFPOS_RANSAC_HYP;
+
+  rfpos_load(self, d, n, m, (const int*) 0, t, (const double*) 0);
+
+  // при n = d + 1 выбросы обнаружить невозможно
+  if (n == u)
+  {
+    for (i = 0; in && i < n; i++)
+      in[i] = 1;
+    return rfpos_solve(self, it, e, d, n, (const double*) 0, t0, r);
+  }
+
+  // при малом числе сочетаний C(n, d+1) перебрать все подмножества
+  for (j = 0, q = 1.; j < u; j++)
+    q = q * (double) (n - j) / (double) (j + 1);
+  all = q <= (double) hyp;
+  for (j = 0; j < u; j++)
+    sub[j] = j;
+
+  for (h = 0, need = hyp; h < need; h++)
+  {
+    // выбрать случайное подмножество из d+1 различных приёмников
+    for (j = 0; !all && j < u; j++)
+      do {
+        sub[j] = (int) (rfpos_rand(&self->rs) % (unsigned) n);
+        for (k = 0; k < j && sub[k] != sub[j]; k++);
+      } while (k < j);
+
+    // решения в замкнутой форме по подмножеству и их оценка по всем
+    // приёмникам (ядро RFPOS_SIMD_*)
+    cnt = rfpos_minimal(self, d, sub, c, &amb);
+    for (k = 0; k < cnt; k++)
+    {
+      cs = self->sc[d](n, c[k], self->y.d, thr, &i);
+      if (nb >= 0 && cs >= best)
+        continue;
+
+      best = cs;
+      nb = i;
+      for (j = 0; j < u; j++)
+        xb[j] = c[k][j];
+
+      // число гипотез, достаточное при доле "своих" приёмников nb / n
+      w = pow((double) nb / (double) n, (double) u);
+      if (w >= 1.)
+        need = 0;
+      else if (w > 0.)
+      {
+        q = log(1. - RFPOS_RANSAC_P) / log(1. - w) + 1.;
+        if (q < (double) need) need = (int) q;
+      }
+    }
+
+    // следующее сочетание в лексикографическом порядке
+    if (all)
+    {
+      for (j = u - 1; j >= 0 && sub[j] == n - u + j; j--);
+      if (j < 0)
+        break; // перебраны все сочетания
+      sub[j]++;
+      for (k = j + 1; k < u; k++)
+        sub[k] = sub[k - 1] + 1;
+    }
+  }
+
+  if (nb < 0)
+    return RFPOS_ERR_SING; // ни одной гипотезы (вырожденная геометрия)
+
+  // отметить "своих" приёмников лучшей гипотезы и сдвинуть их столбцы
+  // в начало матрицы self->y
+  for (i = 0, ni = 0; i < n; i++)
+  {
+    for (j = 0, q = 0.; j < d; j++)
+    {
+      w = xb[j] - self->y.d[j][i];
+      q += w * w;
+    }
+    q = sqrt(q) + xb[d] - self->y.d[d][i];
+    k = q * q <= thr * thr;
+    if (in) in[i] = (unsigned char) k;
+    if (!k) continue;
+
+    for (j = 0; j <= d; j++)
+      self->y.d[j][ni] = self->y.d[j][i];
+    ni++;
+  }
+
+  // уточнить лучшую гипотезу итерациями по "своим" приёмникам
+  for (j = 0; j < u; j++)
+    self->x.d[j] = xb[j];
+  self->nl = ni;
+
+  RFPOS_STAT_BEGIN(self);
+  if (ni < u)
+    retv = RFPOS_ERR_FEW; // недостаточно "своих" приёмников
+  else if (self->opt & RFPOS_OPT_TDOA)
+    retv = rfpos_solve_td(self, it, e, d, ni);
+  else if (self->opt & RFPOS_OPT_LM)
+    retv = rfpos_solve_lm(self, it, e, d, ni);
+  else if (self->opt & RFPOS_OPT_QR)
+    retv = rfpos_solve_qr(self, it, e, d, ni);
+  else if (self->opt & RFPOS_OPT_CHORD)
+    retv = rfpos_solve_ch(self, it, e, d, ni);
+  else
+    retv = rfpos_solve_gn(self, it, e, d, ni);
+  RFPOS_STAT_END(self, retv);
+  self->uc = retv >= 0 ? RFPOS_UC_X : RFPOS_UC_NONE;
+  self->sv = retv >= 0;
+
+  *t0 = self->x.d[d] / RFPOS_C + self->tmin;
+  for (j = 0; j < d; j++)
+    r[j] = self->x.d[j];
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// решение с известной координатой передатчика: в матрицу self->y
+// загружаются d-1 неизвестных координат и дальности, а в строку y[d] -
+// постоянные слагаемые (h - s[i][k])^2, после чего решается задача
+// размерности d-1 (нормальные уравнения d x d вместо (d+1) x (d+1))
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_fix(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (3)
+  int n,           // число приёмников, принявших сигнал (n >= d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  int k,           // номер известной координаты (0...d-1)
+  double h,        // значение известной координаты [м]
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d] (r[k] = h)
+{
+  int i, j, l, dr = d - 1, retv;
+  double tmin, q, pr[RFPOS_D_MAX], rr[RFPOS_D_MAX];
+
+  if (n > self->n) return RFPOS_ERR_N; // ошибка
+  if (d != 3 || d > self->d || k < 0 || k >= d)
+    return RFPOS_ERR_D; // ошибка: поддерживается только d = 3
+  if (n <= dr) return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+
+  // найти минимальное значение t[i]
+  tmin = t[0];
+  for (i = 1; i < n; i++)
+    if (tmin > t[i]) tmin = t[i];
+  self->tmin = tmin;
+  self->nl = n;
+  self->dl = dr;
+  self->fa = RFPOS_FA_NONE;
+  self->uc = RFPOS_UC_NONE;
+  self->sv = self->nc = 0;
+  self->wt = 0;
+  self->kc = 1;
+  self->kf = k;
+
+  // заполнить матрицу исходных данных (по столбцам) без координаты k
+  for (i = 0; i < n; i++)
+  {
+    const double *ptr = m + i * d;
+    for (j = 0, l = 0; j < d; j++)
+      if (j != k)
+        self->y.d[l++][i] = ptr[j];
+
+    self->y.d[dr][i] = (t[i] - tmin) * RFPOS_C; // секунды -> метры
+    q = h - ptr[k];
+    self->y.d[dr + 1][i] = q * q;
+  }
+
+  for (j = 0, l = 0; p && j < d; j++)
+    if (j != k)
+      pr[l++] = p[j];
+
+  retv = rfpos_solve(self, it, e, dr, n, p ? pr : (const double*) 0,
+                     t0, rr);
+
+  for (j = 0, l = 0; j < d; j++)
+    r[j] = j == k ? h : rr[l++];
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// ковариация и DOP последнего решения
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки)
+int rfpos_cov(
+  rfpos_t *self,    // структура данных компонента
+  rfpos_cov_t *cov) // ковариация и DOP
+{
+  int i, j, k, d = self->dl, n = self->nl, u = d + 1, dc, map[RFPOS_U_MAX];
+  double fm = 0., s2, q, g2[RFPOS_U_MAX][RFPOS_U_MAX];
+  la_matrix_t an = self->ws.a, qi = self->g;
+  la_vector_t bn = self->dx;
+  an.nrow = an.ncol = bn.size = qi.nrow = qi.ncol = u;
+
+  if (!self->sv)
+    return RFPOS_ERR_ST; // нет успешно решённого импульса
+
+  if (self->wt && self->fa != RFPOS_FA_NONE)
+  { // нормальная матрица взвешенного МНК уже равна сумме
+    // (e[i], 1) * (e[i], 1)^(T) / (C*sigma[i])^2 - обращается её разложение
+    if (self->fa == RFPOS_FA_RAW && la_chol(&an) < 0)
+    {
+      self->fa = RFPOS_FA_NONE;
+      return RFPOS_ERR_SING; // вырожденная геометрия
+    }
+  }
+  else
+  { // один совмещенный проход: при весах 1/(4*q^2) строки W/(2*q)
+    // равны (e[i], 1), а невязки F/(2*q) - невязкам по дальности
+    if (!self->wt)
+      for (i = 0; i < n; i++)
+        self->sw.d[i] = 0.25;
+    k = self->wt;
+    self->wt = 1;
+    fm = rfpos_fw(self, n, d, &an, &bn);
+    self->wt = k;
+    if (la_chol(&an) < 0)
+    {
+      self->fa = RFPOS_FA_NONE;
+      return RFPOS_ERR_SING; // вырожденная геометрия
+    }
+  }
+  self->fa = self->wt ? RFPOS_FA_CHOL : RFPOS_FA_NONE;
+
+  // Q = A^(-1)
+  la_chol_inv(&an, &qi);
+
+  // дисперсия измерения дальности
+  if (self->wt)
+  {
+    for (i = 0, q = 0.; i < n; i++)
+      q += 4. * self->sw.d[i]; // 1 / (C*sigma[i])^2
+    s2 = (double) n / q;
+  }
+  else
+    s2 = n > u ? fm / (double) (n - u) : 0.;
+  cov->s2 = s2;
+
+  // номера неизвестных в полном векторе (x0, y0, z0, d0)
+  dc = self->kc ? d + 1 : d;
+  for (j = 0, k = 0; j < d; j++, k++)
+  {
+    if (self->kc && k == self->kf) k++;
+    map[j] = k;
+  }
+  map[d] = dc;
+
+  cov->d = dc;
+  for (j = 0; j <= dc; j++)
+    for (k = 0; k <= dc; k++)
+      cov->q[j][k] = g2[j][k] = 0.;
+  for (j = 0; j < u; j++)
+    for (k = 0; k < u; k++)
+    {
+      // взвешенный МНК: A^(-1) - ковариация, DOP - A^(-1) / s2;
+      // обычный МНК: A^(-1) - матрица DOP, ковариация - s2 * A^(-1)
+      q = qi.d[j][k];
+      cov->q[map[j]][map[k]] = self->wt ? q : s2 * q;
+      g2[map[j]][map[k]]     = self->wt ? q / s2 : q;
+    }
+
+  // геометрические факторы
+  cov->hdop = sqrt(g2[0][0] + g2[1][1]);
+  cov->vdop = dc > 2 ? sqrt(g2[2][2]) : 0.;
+  cov->tdop = sqrt(g2[dc][dc]);
+  cov->pdop = sqrt(cov->hdop * cov->hdop + cov->vdop * cov->vdop);
+  cov->gdop = sqrt(cov->pdop * cov->pdop + cov->tdop * cov->tdop);
+
+  // эллипс ошибок в плоскости (x0, y0)
+  q = 0.5 * (cov->q[0][0] - cov->q[1][1]);
+  q = sqrt(q * q + cov->q[0][1] * cov->q[0][1]);
+  s2 = 0.5 * (cov->q[0][0] + cov->q[1][1]);
+  cov->ea = sqrt(s2 + q);
+  cov->eb = s2 > q ? sqrt(s2 - q) : 0.;
+  cov->et = 0.5 * atan2(2. * cov->q[0][1], cov->q[0][0] - cov->q[1][1]);
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// линия положения (гипербола) и пеленг по сигналу двух приёмников
+int rfpos_calc_pair(
+  int d,              // размерность координат (2 или 3)
+  const double *m,    // матрица координат приёмников [2][d]
+  const double *t,    // временные метки приёма сигнала [2]
+  rfpos_pair_t *pair) // линия положения и пеленг
+{
+  int j, e = t[0] <= t[1] ? 0 : 1; // ранний приёмник
+  double q, c = 0., ph, dp;
+  const double *se = m + e * d, *sl = m + (1 - e) * d;
+
+  if (d < 2 || d > RFPOS_D_MAX) return RFPOS_ERR_D; // ошибка
+
+  for (j = 0; j < d; j++)
+  {
+    pair->o[j] = 0.5 * (se[j] + sl[j]);
+    pair->u[j] = q = se[j] - sl[j];
+    c += q * q;
+  }
+  c = 0.5 * sqrt(c);
+  if (c <= 0.)
+    return RFPOS_ERR_SING; // ошибка: приёмники совпадают
+
+  for (j = 0; j < d; j++)
+    pair->u[j] /= 2. * c;
+
+  // разность дальностей не может превышать базу (с учётом шумов)
+  pair->a = 0.5 * fabs(t[1] - t[0]) * RFPOS_C;
+  if (pair->a > c) pair->a = c;
+  pair->c  = c;
+  pair->cb = pair->a / c;
+
+  // горизонтальные направления v, для которых (v, u) = cb
+  pair->naz = 0;
+  q = sqrt(pair->u[0] * pair->u[0] + pair->u[1] * pair->u[1]);
+  if (q > 0. && pair->cb <= q)
+  {
+    ph = atan2(pair->u[1], pair->u[0]);
+    dp = acos(pair->cb / q);
+    pair->az[pair->naz++] = ph + dp;
+    if (dp > 0.)
+      pair->az[pair->naz++] = ph - dp;
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// подготовить разложение self->ul и вектор self->ub в решении self->x
+// последнего импульса: если последний проход итераций Гаусса-Ньютона был
+// выполнен в самой точке решения (ws.a - нормальная матрица, dx - вектор
+// W^(T) * C * F в этой точке), они копируются; разложение ws.a после шага
+// (RFPOS_FA_CHOL) построено в предыдущей точке и не используется - тогда,
+// как и после других решателей, выполняется один совмещенный проход
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки)
+static int rfpos_upd_init(rfpos_t *self)
+{
+  int j, k, u = self->dl + 1;
+  la_matrix_t ln = self->ul;
+  la_vector_t bn = self->ub;
+  ln.nrow = ln.ncol = bn.size = u;
+
+  if (self->uc == RFPOS_UC_CHOL)
+    return 0;
+  if (self->uc != RFPOS_UC_X)
+    return RFPOS_ERR_ST; // нет решённого импульса
+
+  if (self->fa == RFPOS_FA_RAW)
+  {
+    for (j = 0; j < u; j++)
+    {
+      for (k = 0; k <= j; k++)
+        ln.d[j][k] = self->ws.a.d[j][k];
+      bn.d[j] = self->dx.d[j];
+    }
+  }
+  else
+    rfpos_fw(self, self->nl, self->dl, &ln, &bn);
+
+  if (la_chol(&ln) < 0)
+    return RFPOS_ERR_SING; // вырожденная геометрия
+
+  self->uc = RFPOS_UC_CHOL;
+  return 0;
+}
+//----------------------------------------------------------------------------
+// изменение ранга 1 по приёмнику i (sign > 0 - добавить строку, иначе
+// исключить) и одна итерация Гаусса-Ньютона x -= dx из решения
+// (W^(T) * C * W +/- c * w * w^(T)) * dx = W^(T) * C * F +/- c * w * f
+// (в случае успеха возвращается 1, ошибки - отрицательный код ошибки)
+static int rfpos_upd(
+  rfpos_t *self, // структура данных компонента
+  int i,         // номер приёмника (столбец self->y)
+  int sign,      // 1 - добавить, -1 - исключить
+  double *t0,    // оценка времени излучения сигнала передатчиком
+  double *r)     // радиус вектор передатчика [d]
+{
+  int j, d = self->dl, u = d + 1;
+  double w[RFPOS_U_MAX], f = 0., c = 1., q;
+  la_float_t **y = self->y.d;
+  la_matrix_t ln = self->ul;
+  la_vector_t bn = self->ub, dxn = self->dx;
+  ln.nrow = ln.ncol = bn.size = dxn.size = u;
+
+  // строка матрицы Якоби, невязка и вес приёмника i в точке x
+  for (j = 0; j < d; j++)
+  {
+    q = self->x.d[j] - y[j][i];
+    w[j] = 2. * q;
+    f += q * q;
+  }
+  q = self->x.d[d] - y[d][i];
+  w[d] = -2. * q;
+  f -= q * q;
+  if (self->wt)
+  {
+    q *= q;
+    if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+      q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+    c = self->sw.d[i] / q;
+  }
+
+  // изменить разложение на ранг 1 (dx - рабочий вектор sqrt(c) * w)
+  q = sqrt(c);
+  for (j = 0; j < u; j++)
+  {
+    dxn.d[j] = q * w[j];
+    bn.d[j] += sign > 0 ? c * w[j] * f : -c * w[j] * f;
+  }
+  if (la_chol_update(&ln, &dxn, sign) < 0)
+  {
+    self->uc = RFPOS_UC_X; // разложение испорчено - построить заново
+    return RFPOS_ERR_SING;
+  }
+
+  // одна итерация из решения (в новой точке вектор W^(T) * C * F
+  // линейной модели равен нулю)
+  for (j = 0; j < u; j++)
+    dxn.d[j] = bn.d[j];
+  la_chol_solve(&ln, &dxn);
+  for (j = 0; j < u; j++)
+  {
+    self->x.d[j] -= dxn.d[j];
+    bn.d[j] = 0.;
+  }
+  self->fa = RFPOS_FA_NONE;
+
+  *t0 = self->x.d[d] / RFPOS_C + self->tmin;
+  for (j = 0; j < d; j++)
+    r[j] = self->x.d[j];
+
+  return 1;
+}
+//----------------------------------------------------------------------------
+// добавить к последнему решённому импульсу обнаружение ещё одного
+// приёмника (изменение разложения на ранг 1 и одна итерация)
+// (в случае успеха возвращается 1, ошибки - отрицательный код ошибки)
+int rfpos_calc_add(
+  rfpos_t *self,   // структура данных компонента
+  // на входе:
+  const double *m, // координаты приёмника [d]
+  double t,        // временная метка приёма сигнала приёмником [с]
+  double s,        // СКО временной метки [с] (для взвешенного импульса)
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  int j, d = self->dl, n = self->nl, retv;
+
+  if (n >= self->n) return RFPOS_ERR_N; // ошибка
+  if (self->wt && !(s > 0.)) return RFPOS_ERR_ARG; // ошибка: нужно СКО
+
+  retv = rfpos_upd_init(self);
+  if (retv < 0) return retv;
+
+  // новый приёмник - последним столбцом матрицы исходных данных
+  for (j = 0; j < d; j++)
+    self->y.d[j][n] = m[j];
+  self->y.d[d][n] = (t - self->tmin) * RFPOS_C; // секунды -> метры
+  if (self->wt)
+  {
+    double q = 2. * RFPOS_C * s;
+    self->sw.d[n] = 1. / (q * q);
+  }
+
+  retv = rfpos_upd(self, n, 1, t0, r);
+  if (retv >= 0) self->nl = n + 1;
+  return retv;
+}
+//----------------------------------------------------------------------------
+// исключить приёмник i из последнего решённого импульса (изменение
+// разложения на ранг 1 и одна итерация, последний приёмник переносится
+// на место i)
+// (в случае успеха возвращается 1, ошибки - отрицательный код ошибки)
+int rfpos_calc_del(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int i,         // номер приёмника в порядке последнего решения
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  int j, d = self->dl, n = self->nl, retv;
+
+  if (self->uc == RFPOS_UC_NONE)
+    return RFPOS_ERR_ST; // нет решённого импульса
+  if (i < 0 || i >= n)
+    return RFPOS_ERR_ARG; // ошибка: нет приёмника i
+  if (n - 1 <= d) return RFPOS_ERR_FEW; // ошибка: останется n <= d
+
+  retv = rfpos_upd_init(self);
+  if (retv < 0) return retv;
+
+  retv = rfpos_upd(self, i, -1, t0, r);
+  if (retv < 0) return retv;
+
+  for (j = 0; j <= d; j++)
+    self->y.d[j][i] = self->y.d[j][n - 1];
+  if (self->wt)
+    self->sw.d[i] = self->sw.d[n - 1];
+  self->nl = n - 1;
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// решение в замкнутой форме для минимального числа приёмников n = d + 1
+// (возвращается число найденных решений 0...2 или отрицательный код ошибки)
+int rfpos_calc_minimal(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int d,           // размерность координат (2 или 3), число приёмников d+1
+  const double *m, // матрица координат приёмников [d+1][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [d+1]
+  // на выходе:
+  double *t0, // оценки времени излучения сигнала передатчиком [2]
+  double *r,  // радиус векторы передатчика для обоих решений [2][d]
+  int *amb)   // 1 - оба решения физически допустимы (неоднозначность)
+{
+  int j, k, cnt;
+  double c[2][RFPOS_U_MAX];
+
+  if (d + 1 > self->n) return RFPOS_ERR_N; // ошибка
+  if (d > self->d) return RFPOS_ERR_D; // ошибка
+
+  rfpos_load(self, d, d + 1, m, (const int*) 0, t, (const double*) 0);
+  cnt = rfpos_minimal(self, d, (const int*) 0, c, amb);
+
+  for (k = 0; k < cnt; k++)
+  {
+    t0[k] = c[k][d] / RFPOS_C + self->tmin;
+    for (j = 0; j < d; j++)
+      r[k * d + j] = c[k][j];
+  }
+
+  return cnt;
+}
+//----------------------------------------------------------------------------
+// импульс a решается позже импульса b (по сроку dl, импульсы без срока -
+// в конце, при равных сроках - по номеру)
+static int rfpos_edf_after(const double *dl, int a, int b)
+{
+  double da = dl[a] > 0. ? dl[a] : HUGE_VAL;
+  double db = dl[b] > 0. ? dl[b] : HUGE_VAL;
+  return da > db || (da == db && a > b);
+}
+//----------------------------------------------------------------------------
+// опустить элемент j пирамиды ord[m] (в корне - последний по сроку)
+static void rfpos_edf_sift(int *ord, const double *dl, int j, int m)
+{
+  int a = ord[j], c;
+
+  while ((c = 2 * j + 1) < m)
+  {
+    if (c + 1 < m && rfpos_edf_after(dl, ord[c + 1], ord[c]))
+      c++;
+    if (!rfpos_edf_after(dl, ord[c], a))
+      break;
+    ord[j] = ord[c];
+    j = c;
+  }
+  ord[j] = a;
+}
+//----------------------------------------------------------------------------
+// упорядочить номера импульсов ord[k] по возрастанию срока dl
+// (пирамидальная сортировка на месте, без дополнительной памяти)
+static void rfpos_edf(int *ord, const double *dl, int k)
+{
+  int i, a;
+
+  for (i = k / 2 - 1; i >= 0; i--)
+    rfpos_edf_sift(ord, dl, i, k);
+
+  for (i = k - 1; i > 0; i--)
+  {
+    a = ord[i];
+    ord[i] = ord[0];
+    ord[0] = a;
+    rfpos_edf_sift(ord, dl, 0, i);
+  }
+}
+//----------------------------------------------------------------------------
+// пакетное решение задачи для множества импульсов
+// (возвращается число импульсов, для которых решение найдено, или
+// RFPOS_ERR_ARG)
+int rfpos_calc_batch(
+  rfpos_t *self,    // структура данных компонента
+  int it,           // максимальное число итераций
+  double e,         // желаемая численная точность оценки координат [м]
+  int d,            // размерность координат (2 или 3)
+  const double *m,  // матрица координат всех приёмников [][d]
+  rfpos_batch_t *b) // описание пакета импульсов (вход и выход)
+{
+  int i, k, off = 0, cnt = 0;
+  double tdl = self->tdl;
+
+  if (b->tdl && !b->ord)
+    return RFPOS_ERR_ARG; // ошибка: порядок EDF некуда записать
+
+  if (b->tdl)
+  { // порядок EDF; до решения импульса в b->st хранится его смещение
+    for (k = 0; k < b->k; k++)
+    {
+      b->st[k]  = off;
+      b->ord[k] = k;
+      off += b->n[k];
+    }
+    rfpos_edf(b->ord, b->tdl, b->k);
+    off = 0;
+  }
+
+  for (i = 0; i < b->k; i++)
+  {
+    int n, st;
+    const double *p;
+
+    k = i;
+    if (b->tdl)
+    {
+      k = b->ord[i];
+      off = b->st[k];
+      self->tdl = b->tdl[k];
+    }
+    n = b->n[k];
+    p = b->p ? b->p + k * d : (const double*) 0;
+
+    if (n > self->n)
+      st = RFPOS_ERR_N; // ошибка
+    else if (d > self->d)
+      st = RFPOS_ERR_D; // ошибка
+    else if (n <= d)
+      st = RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+    else
+    {
+      rfpos_load(self, d, n, m, b->idx + off, b->t + off,
+                 b->s ? b->s + off : (const double*) 0);
+      st = rfpos_solve(self, it, e, d, n, p, &b->t0[k], &b->r[k * d]);
+      if (st >= 0 && b->cov)
+        rfpos_cov(self, b->cov + k);
+    }
+
+    b->st[k] = st;
+    if (st >= 0) cnt++;
+
+    off += n;
+  }
+  self->tdl = tdl;
+
+  return cnt;
+}
+//----------------------------------------------------------------------------
+// пакетное решение в смешанной точности для импульсов в местных
+// координатах площадки
+// (возвращается число импульсов, для которых решение найдено)
+int rfpos_calc_batch_f(
+  rfpos_t *self,      // структура данных компонента
+  int it,             // максимальное число итераций
+  double e,           // желаемая численная точность оценки координат [м]
+  int d,              // размерность координат (2 или 3)
+  const double *o,    // начало координат площадки [d] или NULL (нуль)
+  const float *m,     // координаты всех приёмников относительно o [][d]
+  rfpos_batch_f_t *b) // описание пакета импульсов (вход и выход)
+{
+  int j, k, cnt = 0, opt = self->opt;
+  const int *idx = b->idx;
+  const float *t = b->t, *s = b->s;
+  double p[RFPOS_D_MAX];
+
+  self->opt |= RFPOS_OPT_F32;
+  for (k = 0; k < b->k; k++)
+  {
+    int n = b->n[k], st;
+    double *r = b->r + k * d;
+
+    if (n > self->n)
+      st = RFPOS_ERR_N; // ошибка
+    else if (d > self->d)
+      st = RFPOS_ERR_D; // ошибка
+    else if (n <= d)
+      st = RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+    else
+    {
+      for (j = 0; b->p && j < d; j++)
+        p[j] = (double) b->p[k * d + j];
+      rfpos_load_f(self, d, n, m, idx, b->tb[k], t, s);
+      st = rfpos_solve(self, it, e, d, n, b->p ? p : (const double*) 0,
+                       &b->t0[k], r);
+      if (st >= 0 && b->cov)
+        rfpos_cov(self, b->cov + k);
+
+      // местные координаты -> абсолютные
+      for (j = 0; o && j < d; j++)
+        r[j] += o[j];
+    }
+
+    b->st[k] = st;
+    if (st >= 0) cnt++;
+
+    idx += n;
+    t   += n;
+    if (s) s += n;
+  }
+  self->opt = opt;
+  self->uc = RFPOS_UC_NONE; // self->x - в местных координатах площадки
+
+  return cnt;
+}
+//----------------------------------------------------------------------------
+// снимок счётчиков решателя (без блокировок; без RFPOS_STATS - нули)
+// (возвращается 1, если счётчики собираются, иначе 0)
+int rfpos_stat_get(const rfpos_t *self, rfpos_stat_t *s)
+{
+#ifdef RFPOS_STATS
+  const unsigned long long *src = (const unsigned long long*) &self->stat;
+  unsigned long long *dst = (unsigned long long*) s;
+  int i;
+
+  for (i = 0; i < (int) (sizeof(rfpos_stat_t) / sizeof(*dst)); i++)
+    dst[i] = __atomic_load_n(src + i, __ATOMIC_RELAXED);
+  return 1;
+#else
+  (void) self;
+  memset(s, 0, sizeof(rfpos_stat_t));
+  return 0;
+#endif // RFPOS_STATS
+}
+//----------------------------------------------------------------------------
+// прибавить счётчики `s` к сумме `sum` (объединение по потокам)
+void rfpos_stat_add(rfpos_stat_t *sum, const rfpos_stat_t *s)
+{
+  unsigned long long *dst = (unsigned long long*) sum;
+  const unsigned long long *src = (const unsigned long long*) s;
+  int i;
 
-  return i; // вернуть число выполненных итераций
+  for (i = 0; i < (int) (sizeof(rfpos_stat_t) / sizeof(*dst)); i++)
+    dst[i] += src[i];
 }
 //----------------------------------------------------------------------------
 // функция тестирования
@@ -11,23 +11,227 @@
 #define RFPOS_H
 //----------------------------------------------------------------------------
 #include "la.h" // библиотека работы с векторами и матрицами
+#include "rfpos_simd.h" // векторные ядра совмещенного прохода
+#include "rfpos_stat.h" // счётчики решателя (RFPOS_STATS)
 //----------------------------------------------------------------------------
 // скорость света в вакууме [м/с]
 #define RFPOS_C 299792458. // +/- 1.2 м/с
 //----------------------------------------------------------------------------
+// максимальная размерность координат и максимальное число неизвестных
+#define RFPOS_D_MAX 3
+#define RFPOS_U_MAX (RFPOS_D_MAX + 1)
+//----------------------------------------------------------------------------
+// допуск [м] при проверке физической допустимости решения в замкнутой
+// форме (сигнал не может быть излучён позже, чем принят)
+#define RFPOS_MIN_TOL 1e-6
+//----------------------------------------------------------------------------
+// порог относительного уменьшения невязки за итерацию, ниже которого
+// итерации прекращаются (достигнут уровень шумов измерений)
+#define RFPOS_REL_TOL 1e-10
+//----------------------------------------------------------------------------
+// начальный коэффициент демпфирования mu метода Левенберга-Марквардта
+// (относительно наибольшего диагонального элемента W^(T) * W)
+#define RFPOS_LM_MU 1e-3
+//----------------------------------------------------------------------------
+// робастный режим (RANSAC): максимальное число гипотез по умолчанию и
+// требуемая вероятность выбрать хотя бы одно подмножество без выбросов
+#define RFPOS_RANSAC_HYP 256
+#define RFPOS_RANSAC_P   0.999
+//----------------------------------------------------------------------------
+// опции решателя (битовая маска поля `opt` структуры `rfpos_t`); при
+// нескольких опциях действует первая из RFPOS_OPT_TDOA, RFPOS_OPT_LM,
+// RFPOS_OPT_QR, а остальные из них и RFPOS_OPT_F32, RFPOS_OPT_CHORD
+// не действуют; RFPOS_OPT_F32 сочетается только с RFPOS_OPT_CHORD
+#define RFPOS_OPT_NONE 0x0 // итерации Гаусса-Ньютона (по умолчанию)
+#define RFPOS_OPT_LM   0x1 // итерации Левенберга-Марквардта (с демпфированием)
+#define RFPOS_OPT_F32  0x2 // итерации Гаусса-Ньютона в float с уточнением
+                           // в double (смешанная точность; не действует
+                           // с RFPOS_OPT_TDOA, RFPOS_OPT_LM, RFPOS_OPT_QR
+                           // и в rfpos_calc_ransac())
+#define RFPOS_OPT_QR   0x4 // итерации Гаусса-Ньютона с решением W * dx = F
+                           // разложением QR (без нормальных уравнений)
+#define RFPOS_OPT_TDOA 0x8 // итерации Гаусса-Ньютона по разностям дальностей:
+                           // d0 исключается, решается система d x d, t0
+                           // восстанавливается по найденной точке
+#define RFPOS_OPT_CHORD 0x10 // итерации с сохранением разложения нормальной
+                             // матрицы (метод хорд с уточнением BFGS)
+//----------------------------------------------------------------------------
+// режим RFPOS_OPT_F32: модуль поправки [м], после которого итерации
+// одинарной точности сменяются итерациями двойной точности
+#define RFPOS_F32_E 1e-3
+//----------------------------------------------------------------------------
+// режим RFPOS_OPT_CHORD: если модуль вектора W^(T) * F уменьшился меньше,
+// чем в 1/RFPOS_CHORD_RHO раз, нормальная матрица строится и раскладывается
+// заново
+#define RFPOS_CHORD_RHO 0.25
+//----------------------------------------------------------------------------
+// коды ошибок rfpos_calc() и других функций решения
+#define RFPOS_ERR_N    -1 // число приёмников больше заданного в rfpos_init()
+#define RFPOS_ERR_D    -2 // размерность больше заданной в rfpos_init()
+#define RFPOS_ERR_FEW  -3 // недостаточно приёмников (n <= d)
+#define RFPOS_ERR_IT   -4 // превышен лимит итераций (точность не достигнута)
+#define RFPOS_ERR_SING -5 // вырожденные нормальные уравнения (геометрия)
+#define RFPOS_ERR_TIME -6 // истёк срок решения (r и t0 - лучшее из
+                          // полученных приближений)
+#define RFPOS_ERR_ST   -7 // нет решённого импульса для rfpos_calc_add(),
+                          // rfpos_calc_del() и rfpos_cov()
+#define RFPOS_ERR_ARG  -8 // неверные аргументы: сроки tdl без ord в пакете,
+                          // нет СКО s > 0 для взвешенного импульса в
+                          // rfpos_calc_add(), номер i вне импульса в
+                          // rfpos_calc_del()
+//----------------------------------------------------------------------------
+// данные подмножества приёмников, не зависящие от временных меток
+// (rfpos_sub_init()): при неподвижных приёмниках вычисляются один раз
+// для подмножества и используются для всех импульсов, принятых им
+typedef struct {
+  int d;  // размерность координат (2 или 3)
+  int n;  // число приёмников подмножества (n > d)
+  int ok; // 1 - геометрия подмножества невырождена (данные заполнены)
+  // n >= d + 2 (линеаризованная исходная точка, опорный приёмник - первый):
+  double gi[RFPOS_D_MAX][RFPOS_D_MAX]; // (4 * sum(dS[i] * dS[i]^(T)))^(-1),
+                                       // dS[i] = S[i] - S[0]
+  // n = d + 1 (решение в замкнутой форме):
+  double z[RFPOS_D_MAX];  // центр масс приёмников Z
+  double ss[RFPOS_U_MAX]; // квадраты расстояний |S[i] - Z|^2
+  double pp[RFPOS_D_MAX][RFPOS_U_MAX]; // псевдообратная (P^(T) * P)^(-1) *
+                                       // P^(T), строки P[i] = S[i] - Z
+} rfpos_sub_t;
+//----------------------------------------------------------------------------
 // структура данных основного компонента
 typedef struct {
   int d; // максимальная размерность координат (2 или 3)
   int n; // максимальное число приёмников, принимающих сигнал передатчика
 
-  la_matrix_t y;  // матрица входных данных [d+1][n]
+  la_matrix_t y;  // матрица входных данных [d+1][n] (по столбцам: x[], y[],
+                  // z[], d[] - "структура массивов" для векторных ядер)
+  la_vector_t sw; // веса взвешенного МНК 1/(2*C*sigma)^2 [n]
+  int wt;         // 1 - текущий импульс решается взвешенным МНК
+  int kc;         // 1 - строка y[d+1] содержит постоянные слагаемые невязки
+                  // (квадраты расстояний по известной координате)
+  int kf;         // номер известной координаты (при kc = 1)
+  int nl, dl;     // число приёмников и размерность последнего решения
+  int fa;         // состояние ws.a после итераций (для rfpos_cov())
+  int sv;         // 1 - последний импульс решён успешно (для rfpos_cov())
+  int nc;         // число итераций последнего решения в режиме
+                  // RFPOS_OPT_CHORD без построения нормальной матрицы
+  const rfpos_sub_t *sub; // данные подмножества текущего импульса или NULL
   la_vector_t x;  // искомые в пространстве и времени координаты [d+1]
-  la_vector_t f;  // вектор "невязки" размера n
-  la_matrix_t w;  // значение матрицы Якоби для x и y
   la_vector_t dx; // вектор решения системы линейных уравнений
+  la_svd_ws_t ws; // нормальная матрица W^(T) * W [d+1][d+1]
+  la_matrix_t wq; // матрица Якоби W [n][d+1] (RFPOS_OPT_QR)
+  la_vector_t fq; // вектор невязки F [n] (RFPOS_OPT_QR)
+  la_matrix_t ul; // разложение Холецкого W^(T) * C * W в решении [d+1][d+1]
+                  // (rfpos_calc_add(), rfpos_calc_del())
+  la_vector_t ub; // вектор W^(T) * C * F в решении [d+1]
+  int uc;         // состояние ul и ub (RFPOS_UC_* в "rfpos.c")
+  la_matrix_t g;  // расширенная матрица для решения в замкнутой форме
+
+  double tmin; // минимальная временная метка последнего импульса [с]
+
+  int simd; // используемый набор инструкций (RFPOS_SIMD_*)
+  rfpos_fw_t fw[RFPOS_D_MAX + 1]; // ядра совмещенного прохода для d=2, 3
+  rfpos_fwf_t fwf[RFPOS_D_MAX + 1]; // то же одинарной точности
+  rfpos_td_t td[RFPOS_D_MAX + 1]; // ядра разностного прохода (RFPOS_OPT_TDOA)
+  rfpos_gr_t gr[RFPOS_D_MAX + 1]; // ядра прохода без нормальной матрицы
+                                  // (RFPOS_OPT_CHORD)
+  float *fb;                    // память столбцов yf и весов swf (или NULL)
+  float *yf[RFPOS_D_MAX + 2];   // столбцы Y в float относительно первого
+                                // приёмника [d+2][n] (RFPOS_OPT_F32)
+  float *swf;                   // веса взвешенного МНК в float [n]
+  rfpos_sc_t sc[RFPOS_D_MAX + 1]; // ядра оценки гипотез RANSAC для d=2, 3
+  unsigned rs; // состояние генератора случайных подмножеств RANSAC
+
+  int opt; // опции решателя RFPOS_OPT_* (rfpos_init() сбрасывает в 0)
+  double tdl; // срок решения импульса по часам rfpos_time() [с] или 0 -
+              // без срока (rfpos_init() сбрасывает в 0)
+
+#ifdef RFPOS_STATS
+  rfpos_stat_t stat;   // счётчики и гистограммы решений (rfpos_stat_get())
+  rfpos_trace_t trace; // история итераций последнего решения
+#endif // RFPOS_STATS
 
 } rfpos_t;
 //----------------------------------------------------------------------------
+// ковариация и геометрические факторы точности решения (rfpos_cov())
+typedef struct {
+  int d;    // размерность координат
+  double q[RFPOS_U_MAX][RFPOS_U_MAX]; // ковариационная матрица (x0, y0, z0,
+                                      // d0) [м^2] (d0 - в метрах дальности)
+  double s2;   // дисперсия измерения дальности [м^2] (для обычного МНК -
+               // апостериорная оценка по невязкам, для взвешенного -
+               // среднее гармоническое (C*sigma)^2)
+  double gdop; // полный геометрический фактор
+  double pdop; // по координатам
+  double hdop; // в горизонтальной плоскости (x0, y0)
+  double vdop; // по высоте z0 (0 при d = 2)
+  double tdop; // по времени излучения (в метрах дальности)
+  double ea, eb; // полуоси эллипса ошибок (1 sigma) в плоскости (x0, y0) [м]
+  double et;     // угол большой полуоси от оси X [рад]
+} rfpos_cov_t;
+//----------------------------------------------------------------------------
+// пакет импульсов в виде "структуры массивов" (SoA) для rfpos_calc_batch()
+// (индексы и временные метки всех импульсов пакета идут подряд)
+typedef struct {
+  // на входе:
+  int k;           // число импульсов в пакете
+  const int *n;    // число приёмников, принявших каждый импульс [k]
+  const int *idx;  // индексы приёмников в матрице координат [sum(n)]
+  const double *t; // временные метки приёма сигнала приёмниками [sum(n)]
+  const double *s; // СКО временных меток [sum(n)] или NULL (без весов)
+  const double *p; // предполагаемые координаты передатчиков [k][d] или NULL
+  // на выходе:
+  double *t0; // оценки времени излучения сигнала передатчиками [k]
+  double *r;  // радиус векторы передатчиков [k][d]
+  int *st;    // код возврата (как у rfpos_calc()) для каждого импульса [k]
+  rfpos_cov_t *cov; // ковариация и DOP решений [k] или NULL
+  // планирование по сроку (EDF):
+  const double *tdl; // сроки решения импульсов по часам rfpos_time() [k]
+                     // (0 - без срока) или NULL (импульсы по порядку)
+  int *ord;          // порядок решения импульсов [k] (на выходе);
+                     // обязателен при tdl != NULL (иначе пакет не
+                     // решается и возвращается RFPOS_ERR_ARG), при
+                     // tdl = NULL не используется
+} rfpos_batch_t;
+//----------------------------------------------------------------------------
+// пакет импульсов в местных координатах площадки для rfpos_calc_batch_f():
+// координаты приёмников задаются в float относительно начала координат
+// площадки, временные метки - в float смещениями от опорного времени
+// импульса (например, первой метки), поэтому таблица приёмников и пакет
+// занимают вдвое меньше памяти, чем для rfpos_calc_batch()
+typedef struct {
+  // на входе:
+  int k;            // число импульсов в пакете
+  const int *n;     // число приёмников, принявших каждый импульс [k]
+  const int *idx;   // индексы приёмников в матрице координат [sum(n)]
+  const double *tb; // опорное время каждого импульса [k] [с]
+  const float *t;   // смещения временных меток от tb [sum(n)] [с]
+  const float *s;   // СКО временных меток [sum(n)] или NULL (без весов)
+  const float *p;   // предполагаемые координаты передатчиков относительно
+                    // начала координат площадки [k][d] или NULL
+  // на выходе:
+  double *t0; // оценки времени излучения сигнала передатчиками [k]
+  double *r;  // радиус векторы передатчиков (абсолютные) [k][d]
+  int *st;    // код возврата (как у rfpos_calc()) для каждого импульса [k]
+  rfpos_cov_t *cov; // ковариация и DOP решений [k] или NULL
+} rfpos_batch_f_t;
+//----------------------------------------------------------------------------
+// линия положения по двум приёмникам (rfpos_calc_pair()): передатчик лежит
+// на ветви гиперболоида |X - S[поздний]| - |X - S[ранний]| = 2 * a с
+// фокусами в приёмниках; направление на удалённый передатчик из центра
+// базы образует с осью u угол arccos(a / c) (конус пеленга)
+typedef struct {
+  double o[RFPOS_D_MAX]; // центр базы (середина между приёмниками) [м]
+  double u[RFPOS_D_MAX]; // единичный вектор оси от позднего приёмника
+                         // к раннему
+  double a;     // половина разности дальностей [м] (0 <= a <= c)
+  double c;     // половина базы [м]
+  double cb;    // косинус угла пеленга относительно оси u (a / c)
+  double az[2]; // азимуты направлений на передатчик в плоскости XY [рад]
+                // (для d = 3 - в предположении, что передатчик удалён
+                // и находится примерно на высоте приёмников)
+  int naz;      // число азимутов 0...2 (два - зеркально относительно базы)
+} rfpos_pair_t;
+//----------------------------------------------------------------------------
 #ifdef __cplusplus
 extern "C" {
 #endif // __cplusplus
@@ -43,9 +247,14 @@ void rfpos_init(
 void rfpos_free(rfpos_t *self);
 //----------------------------------------------------------------------------
 // основная функция для численного решения системы квадратных уравнений
-// (в случае ошибки возвращается отрицательный код ошибки,
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_ERR_*,
 // в случае успеха - число выполненных итераций)
 // координаты передаются и возвращаются в метрах, время в секундах
+// (при n = d + 1 решение находится rfpos_calc_minimal() без итераций,
+// из двух допустимых решений выбирается ближайшее к p)
+// итерации завершаются успешно, когда невязка по всем n приёмникам мала,
+// перестала уменьшаться или поправка стала не больше e; при ошибках
+// RFPOS_ERR_IT и RFPOS_ERR_SING в r и t0 записывается последнее приближение
 int rfpos_calc(
   rfpos_t *self, // структура данных компонента
   // на входе:
@@ -56,10 +265,233 @@ int rfpos_calc(
   const double *m, // матрица координат приёмников [n][d]
   const double *t, // вектор временных меток приёма сигнала приёмниками [n]
   const double *p, // радиус вектор предполагаемого нахождения приёмника [d]
+                   // (или NULL - исходная точка находится линеаризованным
+                   // решением в замкнутой форме при n >= d + 2, иначе
+                   // берётся центр масс приёмников)
   // на выходе:
   double *t0, // оценка времени излучения сигнала передатчиком
   double *r); // радиус вектор приёмника, если решение найдено [d]
 //----------------------------------------------------------------------------
+// взвешенный вариант rfpos_calc(): каждый приёмник задаёт СКО своей
+// временной метки (по отношению сигнал/шум или качеству часов); веса
+// 1/(4 * q^2 * (C*sigma)^2), где q - текущая оценка дальности, учитываются
+// при построении нормальных уравнений без дополнительных матричных
+// произведений; при s = NULL совпадает с rfpos_calc()
+// (для взвешенного МНК невязка безразмерна, поэтому итерации завершаются
+// по модулю поправки или по прекращению уменьшения невязки)
+int rfpos_calc_w(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] (s[i] > 0) или NULL [с]
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+// робастный вариант rfpos_calc() для измерений с выбросами (например,
+// задержка сигнала из-за многолучёвости): для подмножеств из d+1 приёмников
+// находятся решения в замкнутой форме, каждое оценивается по невязкам
+// всех n приёмников (RANSAC), итерации выполняются только по "своим"
+// приёмникам лучшей гипотезы; при числе сочетаний C(n, d+1) не более hyp
+// перебираются все подмножества, иначе - случайные; перебор прекращается
+// досрочно, когда доля "своих" приёмников гарантирует с вероятностью
+// RFPOS_RANSAC_P хотя бы одно подмножество без выбросов
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_ransac(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  double thr,      // порог невязки по дальности "своих" приёмников [м]
+  int hyp,         // максимальное число гипотез (<= 0 - RFPOS_RANSAC_HYP)
+  // на выходе:
+  double *t0,         // оценка времени излучения сигнала передатчиком
+  double *r,          // радиус вектор передатчика [d]
+  unsigned char *in); // признаки "своих" приёмников [n] или NULL
+//----------------------------------------------------------------------------
+// решение с известной координатой передатчика (например, высота задана
+// рельефом или уровнем пола): координата k фиксируется равной h, ищутся
+// только остальные координаты и t0 (система из n уравнений с d
+// неизвестными, приёмники не обязаны лежать в одной плоскости с
+// передатчиком); достаточно n = d приёмников (для d = 3 - трёх), при
+// n = d решение находится в замкнутой форме
+// (коды возврата как у rfpos_calc(); поддерживается d = 3)
+int rfpos_calc_fix(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (3)
+  int n,           // число приёмников, принявших сигнал (n >= d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  int k,           // номер известной координаты (0...d-1, 2 - высота Z)
+  double h,        // значение известной координаты [м]
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d] (r[k] = h)
+//----------------------------------------------------------------------------
+// линия положения (гипербола) и пеленг по сигналу, принятому только
+// двумя приёмниками (см. `rfpos_pair_t`)
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки;
+// при совпадающих приёмниках - RFPOS_ERR_SING)
+int rfpos_calc_pair(
+  int d,               // размерность координат (2 или 3)
+  const double *m,     // матрица координат приёмников [2][d]
+  const double *t,     // временные метки приёма сигнала [2]
+  rfpos_pair_t *pair); // линия положения и пеленг
+//----------------------------------------------------------------------------
+// ковариация и DOP последнего решения rfpos_calc*() (вызывается сразу после
+// успешного решения): если итерации Гаусса-Ньютона взвешенного МНК оставили
+// разложение Холецкого нормальной матрицы, оно обращается без повторного
+// прохода по приёмникам; иначе выполняется один совмещенный проход с весами
+// 1/(4*q^2) (матрица геометрии со строками (e[i], 1)) и разложение (d+1)x(d+1)
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки;
+// до первого решения и после неудачного - RFPOS_ERR_ST; для
+// rfpos_calc_fix() дисперсия известной координаты равна 0)
+int rfpos_cov(
+  rfpos_t *self,     // структура данных компонента
+  rfpos_cov_t *cov); // ковариация и DOP
+//----------------------------------------------------------------------------
+// заполнить данные подмножества приёмников (см. `rfpos_sub_t`); порядок
+// приёмников должен совпадать с порядком в rfpos_calc_sub()
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки;
+// для вырожденной геометрии возвращается 0 и sub->ok = 0)
+int rfpos_sub_init(
+  rfpos_sub_t *sub, // данные подмножества
+  int d,            // размерность координат (2 или 3)
+  int n,            // число приёмников подмножества (n > d)
+  const double *m,  // матрица координат приёмников [][d]
+  const int *idx);  // индексы приёмников в матрице m [n] или NULL
+//----------------------------------------------------------------------------
+// rfpos_calc_w() для импульса с заранее подготовленными данными
+// подмножества приёмников: линеаризованная исходная точка (n >= d + 2)
+// находится без разложения нормальной матрицы, решение в замкнутой форме
+// (n = d + 1) - без исключения Гаусса; при sub = NULL или sub->ok = 0 -
+// как rfpos_calc_w()
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_sub(
+  rfpos_t *self,          // структура данных компонента
+  const rfpos_sub_t *sub, // данные подмножества приёмников или NULL
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [][d]
+  const int *idx,  // индексы приёмников в матрице m [n] или NULL
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] или NULL
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+// добавить к последнему решённому импульсу (rfpos_calc*(), кроме
+// rfpos_calc_fix() и rfpos_calc_batch_f()) опоздавшее обнаружение ещё одного
+// приёмника: разложение Холецкого нормальной матрицы в решении изменяется
+// на ранг 1 (la_chol_update()) и выполняется одна итерация Гаусса-Ньютона
+// за O(d^2) без прохода по остальным приёмникам (первый вызов после
+// решения строит разложение одним совмещенным проходом); строки
+// остальных приёмников не пересчитываются в новой точке, поэтому после
+// многих изменений точнее повторить rfpos_calc()
+// (в случае успеха возвращается 1 - число итераций, ошибки - отрицательный
+// код ошибки; новый приёмник становится последним)
+int rfpos_calc_add(
+  rfpos_t *self,   // структура данных компонента
+  // на входе:
+  const double *m, // координаты приёмника [d]
+  double t,        // временная метка приёма сигнала приёмником [с]
+  double s,        // СКО временной метки [с] (для взвешенного импульса
+                   // s > 0, иначе RFPOS_ERR_ARG; для невзвешенного
+                   // не используется)
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+// исключить из последнего решённого импульса приёмник i (например,
+// выброс): разложение уменьшается на ранг 1 и выполняется одна итерация,
+// как в rfpos_calc_add(); на место приёмника i переносится последний
+// (коды возврата как у rfpos_calc_add(); если останется не больше d
+// приёмников - RFPOS_ERR_FEW, если i < 0 или i >= n - RFPOS_ERR_ARG)
+int rfpos_calc_del(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int i,         // номер приёмника в порядке последнего решения
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+// решение в замкнутой форме (метод Бэнкрофта) для минимального числа
+// приёмников n = d + 1: система квадратных уравнений сводится к одному
+// квадратному уравнению, поэтому решений может быть два; решения
+// упорядочены по правдоподобию (первым - физически допустимое)
+// (возвращается число найденных решений 0...2 или отрицательный код ошибки)
+int rfpos_calc_minimal(
+  rfpos_t *self, // структура данных компонента
+  // на входе:
+  int d,           // размерность координат (2 или 3), число приёмников d+1
+  const double *m, // матрица координат приёмников [d+1][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [d+1]
+  // на выходе:
+  double *t0, // оценки времени излучения сигнала передатчиком [2]
+  double *r,  // радиус векторы передатчика для обоих решений [2][d]
+  int *amb);  // 1 - оба решения физически допустимы (неоднозначность)
+//----------------------------------------------------------------------------
+// пакетное решение задачи для множества импульсов с общим рабочим
+// пространством `self` (координаты приёмников задаются общей таблицей `m`,
+// каждый импульс ссылается на строки таблицы по индексам); при заданных
+// сроках b->tdl импульсы решаются в порядке возрастания срока (EDF), срок
+// каждого импульса действует как self->tdl
+// (возвращается число импульсов, для которых решение найдено, или
+// RFPOS_ERR_ARG, если задано b->tdl без b->ord)
+int rfpos_calc_batch(
+  rfpos_t *self,    // структура данных компонента
+  int it,           // максимальное число итераций
+  double e,         // желаемая численная точность оценки координат [м]
+  int d,            // размерность координат (2 или 3)
+  const double *m,  // матрица координат всех приёмников [][d]
+  rfpos_batch_t *b); // описание пакета импульсов (вход и выход)
+//----------------------------------------------------------------------------
+// пакетное решение в смешанной точности для импульсов в местных
+// координатах площадки (см. `rfpos_batch_f_t`): итерации выполняются
+// в режиме RFPOS_OPT_F32, если в self->opt не заданы RFPOS_OPT_TDOA,
+// RFPOS_OPT_LM или RFPOS_OPT_QR (тогда итерации одинарной точности не
+// выполняются и решение идёт только в double), решения возвращаются
+// в абсолютных координатах в double
+// (возвращается число импульсов, для которых решение найдено)
+int rfpos_calc_batch_f(
+  rfpos_t *self,      // структура данных компонента
+  int it,             // максимальное число итераций
+  double e,           // желаемая численная точность оценки координат [м]
+  int d,              // размерность координат (2 или 3)
+  const double *o,    // начало координат площадки [d] или NULL (нуль)
+  const float *m,     // координаты всех приёмников относительно o [][d]
+  rfpos_batch_f_t *b); // описание пакета импульсов (вход и выход)
+//----------------------------------------------------------------------------
+// монотонное время [с] (CLOCK_MONOTONIC) для задания срока решения:
+// self->tdl = rfpos_time() + бюджет времени импульса
+double rfpos_time(void);
+//----------------------------------------------------------------------------
+// снимок счётчиков решателя (можно вызывать из другого потока во время
+// решения, без блокировок); без RFPOS_STATS счётчики нулевые
+// (возвращается 1, если счётчики собираются, иначе 0)
+int rfpos_stat_get(const rfpos_t *self, rfpos_stat_t *s);
+//----------------------------------------------------------------------------
+// прибавить счётчики `s` к сумме `sum` (объединение по потокам)
+void rfpos_stat_add(rfpos_stat_t *sum, const rfpos_stat_t *s);
+//----------------------------------------------------------------------------
 // функция тестирования
 void rfpos_test(
   // на входе:
@@ -0,0 +1,309 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (специализированный C++ вариант для фиксированных d и n, без кучи)
+ * Version: 0.1b
+ * File: "rfpos.hpp"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_HPP
+#define RFPOS_HPP
+//----------------------------------------------------------------------------
+#include <math.h> // sqrt()
+#include "rfpos.h" // RFPOS_C
+//----------------------------------------------------------------------------
+namespace rfpos {
+//----------------------------------------------------------------------------
+// решатель для размерности D (2 или 3) и не более NMax приёмников;
+// алгоритм совпадает с rfpos_calc() без опций (итерации Гаусса-Ньютона из
+// p или из линеаризованного решения), но все массивы имеют фиксированный
+// размер, циклы по D раскрываются компилятором, а нормальные уравнения
+// (D+1)x(D+1) решаются разложением Холецкого без la_matrix_t и без
+// выделения памяти; решение в замкнутой форме для n = D + 1 (метод
+// Бэнкрофта) не реализовано - при n = D + 1 и p = NULL итерации начинаются
+// из центра масс приёмников и могут сойтись к другому корню, чем
+// rfpos_calc()
+template <int D, int NMax>
+class Solver {
+  static_assert(D == 2 || D == 3, "D must be 2 or 3");
+  static_assert(NMax > D, "NMax must be greater than D");
+
+public:
+  enum { U = D + 1 }; // число неизвестных (x, y[, z], d0)
+
+  Solver() : tmin(0.) {}
+
+  // основная функция (параметры и код возврата как у rfpos_calc() без
+  // опций, т.е. итерации Гаусса-Ньютона с теми же критериями остановки)
+  int calc(
+    // на входе:
+    int it,          // максимальное число итераций
+    double e,        // желаемая численная точность оценки координат [м]
+    int n,           // число приёмников, принявших сигнал (D < n <= NMax)
+    const double *m, // матрица координат приёмников [n][D]
+    const double *t, // вектор временных меток приёма сигнала [n]
+    const double *p, // предполагаемые координаты передатчика [D] или NULL
+    // на выходе:
+    double *t0, // оценка времени излучения сигнала передатчиком
+    double *r)  // радиус вектор передатчика [D]
+  {
+    int i, j, retv;
+    double fp = 0.;
+
+    if (n > NMax) return RFPOS_ERR_N; // ошибка
+    if (n <= D) return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+
+    load(n, m, t);
+    guess(n, p);
+
+    // цикл итераций Гаусса-Ньютона
+    e *= e;
+    for (i = 0;; i++)
+    {
+      double a[U][U], b[U], s = 0.;
+
+      // невязка по всем n приёмникам и нормальные уравнения за один проход
+      double fm = normal(n, a, b);
+      if (fm <= e)
+      {
+        retv = i; // успех: невязка мала
+        break;
+      }
+
+      if (i > 0 && fm <= fp && fp - fm <= RFPOS_REL_TOL * fp)
+      {
+        retv = i; // успех: невязка перестала уменьшаться
+        break;
+      }
+
+      // проверить лимит итераций
+      if (i >= it)
+      {
+        retv = RFPOS_ERR_IT; // превышен лимит итераций
+        break;
+      }
+
+      // нормальные уравнения W^(T) * W * dx = W^(T) * F
+      if (!chol_solve(a, b))
+      {
+        retv = RFPOS_ERR_SING; // вырожденная геометрия
+        break;
+      }
+
+      // выполнить коррекцию: x -= dx
+      for (j = 0; j < U; j++)
+      {
+        x[j] -= b[j];
+        s += b[j] * b[j];
+      }
+
+      if (s <= e)
+      {
+        retv = i + 1; // успех: поправка меньше требуемой точности
+        break;
+      }
+      fp = fm;
+    }
+
+    // заполнить выходные данные
+    *t0 = x[D] / RFPOS_C + tmin;
+    for (j = 0; j < D; j++)
+      r[j] = x[j];
+
+    return retv;
+  }
+
+private:
+  double y[NMax][U]; // матрица входных данных
+  double x[U];       // искомые в пространстве и времени координаты
+  double tmin;       // минимальная временная метка [с]
+
+  // заполнить матрицу исходных данных
+  void load(int n, const double *m, const double *t)
+  {
+    int i, j;
+    tmin = t[0];
+    for (i = 1; i < n; i++)
+      if (tmin > t[i]) tmin = t[i];
+    for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < D; j++)
+        y[i][j] = *m++;
+      y[i][D] = (t[i] - tmin) * RFPOS_C; // секунды -> метры
+    }
+  }
+
+  // выбрать исходную точку поиска (как в rfpos_guess()): по p, иначе
+  // линеаризованным решением (n >= D + 2), иначе по центру масс приёмников
+  void guess(int n, const double *p)
+  {
+    int i, j;
+    if (!p && guess_lin(n))
+      return; // d0 найдено вместе с координатами
+
+    for (j = 0; j < D; j++)
+    {
+      if (p)
+        x[j] = p[j];
+      else
+      { // центр масс приёмников
+        double s = 0.;
+        for (i = 0; i < n; i++)
+          s += y[i][j];
+        x[j] = s / (double) n;
+      }
+    }
+
+    double d0 = 0.;
+    for (i = 0; i < n; i++)
+    {
+      double dd = 0.;
+      for (j = 0; j < D; j++)
+      {
+        double q = x[j] - y[i][j];
+        dd += q * q;
+      }
+      d0 += y[i][D] - sqrt(dd);
+    }
+    x[D] = d0 / (double) n;
+  }
+
+  // линеаризованное решение в замкнутой форме (как rfpos_guess_lin()):
+  // разности уравнений относительно первым принявшего сигнал приёмника r
+  //   2 (S[i] - S[r]) * X - 2 (d[i] - d[r]) * d0 =
+  //     = |S[i] - S[r]|^2 - d[i]^2 + d[r]^2, i != r
+  // решаются МНК однократно (в случае успеха возвращается true)
+  bool guess_lin(int n)
+  {
+    int i, j, k, r = 0;
+    double a[U][U], b[U];
+
+    if (n < D + 2) return false; // система недоопределена
+
+    for (i = 1; i < n; i++)
+      if (y[i][D] < y[r][D]) r = i;
+
+    for (j = 0; j < U; j++)
+    {
+      b[j] = 0.;
+      for (k = 0; k <= j; k++)
+        a[j][k] = 0.;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+      double w[U], f = 0., q;
+      if (i == r) continue;
+
+      for (j = 0; j < D; j++)
+      {
+        q = y[i][j] - y[r][j];
+        w[j] = 2. * q;
+        f += q * q;
+      }
+      q = y[i][D];
+      w[D] = -2. * (q - y[r][D]);
+      f += y[r][D] * y[r][D] - q * q;
+
+      for (j = 0; j < U; j++)
+      {
+        for (k = 0; k <= j; k++)
+          a[j][k] += w[j] * w[k];
+        b[j] += w[j] * f;
+      }
+    }
+
+    if (!chol_solve(a, b))
+      return false; // вырожденная геометрия
+
+    for (j = 0; j < D; j++)
+      x[j] = b[j] + y[r][j];
+    x[D] = b[D];
+    return true;
+  }
+
+  // нижний треугольник W^(T) * W и вектор W^(T) * F, где невязка F(X,Y)
+  // и строки W вычисляются "на лету" (аналог rfpos_fw() без хранения
+  // матрицы Якоби); возвращается |F|^2 по всем n приёмникам
+  double normal(int n, double a[U][U], double b[U]) const
+  {
+    int i, j, k;
+    double fm = 0.;
+    for (j = 0; j < U; j++)
+    {
+      b[j] = 0.;
+      for (k = 0; k <= j; k++)
+        a[j][k] = 0.;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+      double w[U], f = 0., q;
+      for (j = 0; j < D; j++)
+      {
+        q = x[j] - y[i][j];
+        w[j] = 2. * q;
+        f += q * q;
+      }
+      q = x[D] - y[i][D];
+      w[D] = -2. * q;
+      f -= q * q;
+      fm += f * f;
+
+      for (j = 0; j < U; j++)
+      {
+        for (k = 0; k <= j; k++)
+          a[j][k] += w[j] * w[k];
+        b[j] += w[j] * f;
+      }
+    }
+    return fm;
+  }
+
+  // решение A * X = B по разложению Холецкого (B заменяется на X)
+  // (в случае успеха возвращается true)
+  static bool chol_solve(double a[U][U], double b[U])
+  {
+    int i, j, k;
+    for (j = 0; j < U; j++)
+    {
+      double s = a[j][j];
+      for (k = 0; k < j; k++)
+        s -= a[j][k] * a[j][k];
+      if (s <= 0.)
+        return false;
+      a[j][j] = s = sqrt(s);
+      for (i = j + 1; i < U; i++)
+      {
+        double q = a[i][j];
+        for (k = 0; k < j; k++)
+          q -= a[i][k] * a[j][k];
+        a[i][j] = q / s;
+      }
+    }
+
+    for (i = 0; i < U; i++)
+    {
+      double s = b[i];
+      for (k = 0; k < i; k++)
+        s -= a[i][k] * b[k];
+      b[i] = s / a[i][i];
+    }
+    for (i = U - 1; i >= 0; i--)
+    {
+      double s = b[i];
+      for (k = i + 1; k < U; k++)
+        s -= a[k][i] * b[k];
+      b[i] = s / a[i][i];
+    }
+    return true;
+  }
+};
+//----------------------------------------------------------------------------
+} // namespace rfpos
+//----------------------------------------------------------------------------
+#endif // RFPOS_HPP
+
+/*** end of "rfpos.hpp" ***/
@@ -0,0 +1,295 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (ассоциация независимых потоков обнаружений приёмников в импульсы)
+ * Version: 0.1b
+ * File: "rfpos_assoc.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include <math.h> // sqrt(), HUGE_VAL
+#include "rfpos_assoc.h"
+//----------------------------------------------------------------------------
+// самая ранняя метка буфера приёмника i (ключ кучи)
+#define RFPOS_ASSOC_KEY(self, i) \
+  ((self)->buf[(i) * (self)->cap + (self)->beg[i]])
+//----------------------------------------------------------------------------
+// поднять приёмник из позиции k кучи к корню
+static void rfpos_assoc_up(rfpos_assoc_t *self, int k)
+{
+  int i = self->hp[k], j;
+  double key = RFPOS_ASSOC_KEY(self, i);
+
+  while (k > 0)
+  {
+    j = self->hp[(k - 1) >> 1];
+    if (RFPOS_ASSOC_KEY(self, j) <= key)
+      break;
+    self->hp[k] = j;
+    self->pos[j] = k;
+    k = (k - 1) >> 1;
+  }
+  self->hp[k] = i;
+  self->pos[i] = k;
+}
+//----------------------------------------------------------------------------
+// опустить приёмник из позиции k кучи к листьям
+static void rfpos_assoc_down(rfpos_assoc_t *self, int k)
+{
+  int i = self->hp[k], j, c;
+  double key = RFPOS_ASSOC_KEY(self, i);
+
+  while ((c = 2 * k + 1) < self->hn)
+  {
+    if (c + 1 < self->hn &&
+        RFPOS_ASSOC_KEY(self, self->hp[c + 1]) <
+        RFPOS_ASSOC_KEY(self, self->hp[c]))
+      c++;
+    j = self->hp[c];
+    if (key <= RFPOS_ASSOC_KEY(self, j))
+      break;
+    self->hp[k] = j;
+    self->pos[j] = k;
+    k = c;
+  }
+  self->hp[k] = i;
+  self->pos[i] = k;
+}
+//----------------------------------------------------------------------------
+// вынуть из кучи приёмник с самой ранней меткой
+static int rfpos_assoc_take(rfpos_assoc_t *self)
+{
+  int i = self->hp[0];
+
+  self->pos[i] = -1;
+  if (--self->hn > 0)
+  {
+    self->hp[0] = self->hp[self->hn];
+    rfpos_assoc_down(self, 0);
+  }
+  return i;
+}
+//----------------------------------------------------------------------------
+// вернуть в кучу приёмник i (если его буфер не пуст)
+static void rfpos_assoc_put(rfpos_assoc_t *self, int i)
+{
+  if (self->cnt[i] > 0)
+  {
+    self->hp[self->hn] = i;
+    rfpos_assoc_up(self, self->hn++);
+  }
+}
+//----------------------------------------------------------------------------
+// инициализация ассоциатора, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_ASSOC_ERR_*)
+int rfpos_assoc_init(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int d,               // размерность координат (2 или 3)
+  int n,               // число приёмников в таблице
+  const double *m,     // таблица координат приёмников [n][d]
+  int cap,             // ёмкость буфера приёмника (округляется до 2^k)
+  double lag,          // допустимое опоздание обнаружений [с]
+  double tol,          // допуск на ошибку временных меток [с]
+  int nmin)            // минимальное число приёмников в импульсе (> d)
+{
+  int i, j, k;
+  double w = 0.;
+
+  if (n < 1 || d < 2 || d > RFPOS_D_MAX || cap < 1 || nmin < 1 ||
+      !(lag >= 0.) || !(tol >= 0.))
+    return RFPOS_ASSOC_ERR_ARG;
+
+  // окно импульса по максимальной базе O(n^2)
+  for (i = 0; i < n; i++)
+    for (j = i + 1; j < n; j++)
+    {
+      double q, dd = 0.;
+      for (k = 0; k < d; k++)
+      {
+        q = m[i * d + k] - m[j * d + k];
+        dd += q * q;
+      }
+      if (dd > w) w = dd;
+    }
+
+  for (self->cap = 1; self->cap < cap; self->cap <<= 1);
+
+  self->d    = d;
+  self->n    = n;
+  self->m    = m;
+  self->w    = sqrt(w) / RFPOS_C;
+  self->tol  = tol;
+  self->lag  = lag;
+  self->nmin = nmin;
+  self->fin  = 0;
+  self->tmax = -HUGE_VAL;
+  self->hn   = 0;
+
+  self->groups = 0;
+  self->late   = 0;
+  self->full   = 0;
+  self->drop   = 0;
+
+  self->buf = (double*) la_malloc(sizeof(double) * n * self->cap);
+  self->beg = (int*) la_malloc(sizeof(int) * n * 5);
+  if (!self->buf || !self->beg)
+  {
+    rfpos_assoc_free(self);
+    return RFPOS_ASSOC_ERR_MEM;
+  }
+  self->cnt = self->beg + n;
+  self->hp  = self->beg + n * 2;
+  self->pos = self->beg + n * 3;
+  self->tmp = self->beg + n * 4;
+
+  for (i = 0; i < n; i++)
+  {
+    self->beg[i] = self->cnt[i] = 0;
+    self->pos[i] = -1;
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_assoc_free(rfpos_assoc_t *self)
+{
+  if (self->buf) la_free(self->buf);
+  if (self->beg) la_free(self->beg);
+  self->buf = (double*) 0;
+  self->beg = (int*) 0;
+  self->hn  = 0;
+}
+//----------------------------------------------------------------------------
+// добавить обнаружение приёмника
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_ASSOC_ERR_*)
+int rfpos_assoc_push(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int i,               // индекс приёмника в таблице
+  double t)            // временная метка приёма сигнала [с]
+{
+  int k, mask = self->cap - 1, beg;
+  double *b;
+
+  if (i < 0 || i >= self->n || t != t)
+    return RFPOS_ASSOC_ERR_ARG;
+
+  self->fin = 0;
+  if (t < self->tmax - self->lag)
+  { // импульс с этой меткой мог быть уже выдан
+    self->late++;
+    return RFPOS_ASSOC_ERR_LATE;
+  }
+
+  k = self->cnt[i];
+  if (k == self->cap)
+  {
+    self->full++;
+    return RFPOS_ASSOC_ERR_FULL;
+  }
+
+  // вставка с конца буфера: метки приходят почти по порядку, сдвиг
+  // ограничен числом меток приёмника в пределах опоздания
+  b   = self->buf + i * self->cap;
+  beg = self->beg[i];
+  for (; k > 0 && b[(beg + k - 1) & mask] > t; k--)
+    b[(beg + k) & mask] = b[(beg + k - 1) & mask];
+  b[(beg + k) & mask] = t;
+  self->cnt[i]++;
+
+  if (t > self->tmax)
+    self->tmax = t;
+
+  if (self->pos[i] < 0)
+  { // буфер был пуст
+    self->hp[self->hn] = i;
+    rfpos_assoc_up(self, self->hn++);
+  }
+  else if (k == 0) // новая самая ранняя метка приёмника
+    rfpos_assoc_up(self, self->pos[i]);
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// выдать очередной закрытый импульс
+// (возвращается число приёмников импульса или 0, если закрытых нет)
+int rfpos_assoc_pop(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int *idx,            // индексы приёмников импульса [n]
+  double *t)           // временные метки импульса [n]
+{
+  int i, i0, j, k, nt, d = self->d, mask = self->cap - 1;
+  double t0, ti, lim;
+  const double *m0;
+
+  while (self->hn > 0)
+  {
+    i0  = self->hp[0];
+    t0  = RFPOS_ASSOC_KEY(self, i0);
+    lim = t0 + self->w + self->tol;
+
+    // все метки окна должны были прийти (более поздние - опоздавшие)
+    if (!self->fin && lim > self->tmax - self->lag)
+      return 0;
+
+    // самая ранняя метка открывает импульс
+    rfpos_assoc_take(self);
+    idx[0] = i0;
+    t[0]   = t0;
+    k = 1;
+    self->beg[i0] = (self->beg[i0] + 1) & mask;
+    self->cnt[i0]--;
+    self->tmp[0] = i0;
+    nt = 1;
+
+    // приёмники с метками в окне; метка входит в импульс, если разность
+    // с самой ранней не больше расстояния между приёмниками / RFPOS_C
+    m0 = self->m + i0 * d;
+    while (self->hn > 0 &&
+           (ti = RFPOS_ASSOC_KEY(self, self->hp[0])) <= lim)
+    {
+      const double *mi;
+      double q, dd = 0.;
+
+      i = rfpos_assoc_take(self);
+      self->tmp[nt++] = i;
+
+      mi = self->m + i * d;
+      for (j = 0; j < d; j++)
+      {
+        q = mi[j] - m0[j];
+        dd += q * q;
+      }
+      if ((ti - t0) * RFPOS_C > sqrt(dd) + self->tol * RFPOS_C)
+        continue; // физически невозможно: метка другого импульса
+
+      idx[k] = i;
+      t[k++] = ti;
+      self->beg[i] = (self->beg[i] + 1) & mask;
+      self->cnt[i]--;
+    }
+
+    // вернуть в кучу приёмники с оставшимися метками
+    for (j = 0; j < nt; j++)
+      rfpos_assoc_put(self, self->tmp[j]);
+
+    if (k >= self->nmin)
+    {
+      self->groups++;
+      return k;
+    }
+    self->drop += k;
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// конец потока: выдать все оставшиеся импульсы
+void rfpos_assoc_flush(rfpos_assoc_t *self)
+{
+  self->fin = 1;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_assoc.c" ***/
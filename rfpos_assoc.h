@@ -0,0 +1,101 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (ассоциация независимых потоков обнаружений приёмников в импульсы)
+ * Version: 0.1b
+ * File: "rfpos_assoc.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_ASSOC_H
+#define RFPOS_ASSOC_H
+//----------------------------------------------------------------------------
+#include "rfpos.h" // RFPOS_C, RFPOS_D_MAX, la_malloc()
+//----------------------------------------------------------------------------
+// коды ошибок
+#define RFPOS_ASSOC_ERR_ARG  -1 // недопустимые параметры
+#define RFPOS_ASSOC_ERR_MEM  -2 // нет памяти
+#define RFPOS_ASSOC_ERR_LATE -3 // обнаружение опоздало (старше водяного знака)
+#define RFPOS_ASSOC_ERR_FULL -4 // кольцевой буфер приёмника переполнен
+//----------------------------------------------------------------------------
+// ассоциатор обнаружений: у каждого приёмника кольцевой буфер временных
+// меток, упорядоченный по времени; приёмники собраны в двоичную кучу
+// по времени самой ранней метки буфера; импульс закрывается, когда
+// водяной знак (максимальная метка минус допустимое опоздание) ушёл
+// за физически возможное окно самой ранней метки; память фиксирована
+typedef struct {
+  int d;            // размерность координат (2 или 3)
+  int n;            // число приёмников в таблице
+  const double *m;  // таблица координат приёмников [n][d] (память
+                    // вызывающего, не изменяется, пока используется)
+
+  double w;    // окно импульса: максимальная база / RFPOS_C [с]
+  double tol;  // допуск на ошибку временных меток [с]
+  double lag;  // допустимое опоздание обнаружений (водяной знак) [с]
+  int nmin;    // минимальное число приёмников в импульсе
+  int cap;     // ёмкость буфера приёмника (степень двойки)
+  int fin;     // 1 - конец потока (закрываются все импульсы)
+  double tmax; // максимальная полученная временная метка [с]
+
+  double *buf; // кольцевые буферы временных меток [n][cap]
+  int *beg;    // индексы самых ранних меток буферов [n]
+  int *cnt;    // число меток в буферах [n]
+  int *hp;     // куча приёмников с непустыми буферами [n]
+  int *pos;    // позиции приёмников в куче (или -1) [n]
+  int hn;      // число приёмников в куче
+  int *tmp;    // приёмники, временно вынутые из кучи [n]
+
+  long groups; // число выданных импульсов (статистика)
+  long late;   // число опоздавших обнаружений (статистика)
+  long full;   // число обнаружений, не вошедших в буфер (статистика)
+  long drop;   // число обнаружений импульсов менее nmin приёмников
+} rfpos_assoc_t;
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// инициализация ассоциатора, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_ASSOC_ERR_*)
+int rfpos_assoc_init(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int d,               // размерность координат (2 или 3)
+  int n,               // число приёмников в таблице
+  const double *m,     // таблица координат приёмников [n][d]
+  int cap,             // ёмкость буфера приёмника (округляется до 2^k)
+  double lag,          // допустимое опоздание обнаружений [с]
+  double tol,          // допуск на ошибку временных меток [с]
+  int nmin);           // минимальное число приёмников в импульсе (> d)
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_assoc_free(rfpos_assoc_t *self);
+//----------------------------------------------------------------------------
+// добавить обнаружение приёмника (метки одного приёмника могут приходить
+// не по порядку в пределах допустимого опоздания)
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_ASSOC_ERR_*)
+int rfpos_assoc_push(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int i,               // индекс приёмника в таблице
+  double t);           // временная метка приёма сигнала [с]
+//----------------------------------------------------------------------------
+// выдать очередной закрытый импульс: самая ранняя метка и метки других
+// приёмников, отстоящие от неё не более чем на базу / RFPOS_C + tol;
+// приёмники импульса упорядочены по времени приёма
+// (возвращается число приёмников импульса или 0, если закрытых нет)
+int rfpos_assoc_pop(
+  rfpos_assoc_t *self, // структура данных ассоциатора
+  int *idx,            // индексы приёмников импульса [n]
+  double *t);          // временные метки импульса [n]
+//----------------------------------------------------------------------------
+// конец потока: следующие вызовы rfpos_assoc_pop() выдают все оставшиеся
+// импульсы; новый вызов rfpos_assoc_push() снова включает водяной знак
+void rfpos_assoc_flush(rfpos_assoc_t *self);
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_ASSOC_H
+
+/*** end of "rfpos_assoc.h" ***/
@@ -0,0 +1,445 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (сетка ожидаемых дальностей для выбора исходной точки поиска)
+ * Version: 0.1b
+ * File: "rfpos_grid.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include <stdio.h>    // fopen(), fwrite(), fclose()
+#include <string.h>   // memcpy(), memcmp()
+#include <math.h>     // sqrt(), fabs(), floor()
+#include <fcntl.h>    // open()
+#include <unistd.h>   // close()
+#include <sys/mman.h> // mmap(), munmap()
+#include <sys/stat.h> // fstat()
+#include "rfpos_grid.h"
+//----------------------------------------------------------------------------
+// допуск [м] при сравнении координат приёмников с записанными в файле
+#define RFPOS_GRID_TOL 1e-6
+//----------------------------------------------------------------------------
+// кандидат поиска
+typedef struct {
+  int i[3];   // номер узла по осям
+  double f;   // рассогласование дальностей
+} rfpos_grid_cand_t;
+//----------------------------------------------------------------------------
+// шаг верхнего уровня поиска: не более RFPOS_GRID_TOP узлов
+// (возвращается шаг, в ts записывается число узлов по осям)
+static int rfpos_grid_top(const int *size, int *ts)
+{
+  int j, s = 1;
+
+  for (;;)
+  {
+    long top = 1;
+    for (j = 0; j < 3; j++)
+    {
+      ts[j] = (size[j] - 1) / s + 1;
+      top *= ts[j];
+    }
+    if (top <= RFPOS_GRID_TOP)
+      return s;
+    s <<= 1;
+  }
+}
+//----------------------------------------------------------------------------
+// размер файла сетки [байт]
+static size_t rfpos_grid_len(int d, int n, const int *size, const int *ts)
+{
+  return sizeof(rfpos_grid_hdr_t) + sizeof(double) * n * d +
+         sizeof(float) * n * ((size_t) size[0] * size[1] * size[2] +
+                              (size_t) ts[0] * ts[1] * ts[2]);
+}
+//----------------------------------------------------------------------------
+// дальность от узла (ix, iy, iz) до приёмника i [м]
+static float rfpos_grid_range(
+  const rfpos_grid_hdr_t *hdr, // заголовок
+  const double *m,             // таблица координат приёмников [n][d]
+  int ix, int iy, int iz,      // номер узла по осям
+  int i)                       // номер приёмника
+{
+  int j, d = hdr->d, in[3];
+  double q, sq = 0.;
+
+  in[0] = ix;
+  in[1] = iy;
+  in[2] = iz;
+  for (j = 0; j < d; j++)
+  {
+    q = hdr->lo[j] + in[j] * hdr->step - m[i * d + j];
+    sq += q * q;
+  }
+
+  return (float) sqrt(sq);
+}
+//----------------------------------------------------------------------------
+// построить сетку над параллелепипедом [lo, hi] и записать в файл
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_GRID_ERR_*)
+int rfpos_grid_build(
+  const char *fname, // имя файла
+  int d,             // размерность координат (2 или 3)
+  int n,             // число приёмников
+  const double *m,   // таблица координат приёмников [n][d]
+  const double *lo,  // нижняя граница области [d]
+  const double *hi,  // верхняя граница области [d]
+  double step)       // шаг сетки [м]
+{
+  int i, j, ix, iy, iz, k, s, size[3], ts[3], nt, retv = 0;
+  rfpos_grid_hdr_t hdr;
+  float *row, *rt;
+  FILE *f;
+
+  if (d < 2 || d > RFPOS_D_MAX || n < 1 || !(step > 0.))
+    return RFPOS_GRID_ERR_ARG;
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, RFPOS_GRID_MAGIC, sizeof(hdr.magic));
+  hdr.version = RFPOS_GRID_VERSION;
+  hdr.d = d;
+  hdr.n = n;
+  hdr.step = step;
+  for (j = 0; j < 3; j++)
+  {
+    if (j < d)
+    {
+      if (!(hi[j] >= lo[j]))
+        return RFPOS_GRID_ERR_ARG;
+      hdr.lo[j]   = lo[j];
+      hdr.size[j] = (uint32_t) floor((hi[j] - lo[j]) / step + 1e-9) + 1;
+    }
+    else
+      hdr.size[j] = 1;
+    size[j] = hdr.size[j];
+  }
+  s = rfpos_grid_top(size, ts);
+  nt = ts[0] * ts[1] * ts[2];
+  hdr.top = s;
+
+  row = (float*) la_malloc(sizeof(float) * n * size[0]);
+  rt  = (float*) la_malloc(sizeof(float) * n * nt);
+  if (!row || !rt)
+  {
+    la_free(rt);
+    la_free(row);
+    return RFPOS_GRID_ERR_MEM;
+  }
+
+  f = fopen(fname, "wb");
+  if (!f)
+  {
+    la_free(rt);
+    la_free(row);
+    return RFPOS_GRID_ERR_IO;
+  }
+
+  if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+      fwrite(m, sizeof(double) * d, n, f) != (size_t) n)
+    retv = RFPOS_GRID_ERR_IO;
+
+  // все узлы (по строкам вдоль оси X)
+  for (iz = 0; iz < size[2] && !retv; iz++)
+    for (iy = 0; iy < size[1] && !retv; iy++)
+    {
+      for (ix = 0; ix < size[0]; ix++)
+        for (i = 0; i < n; i++)
+          row[ix * n + i] = rfpos_grid_range(&hdr, m, ix, iy, iz, i);
+      if (fwrite(row, sizeof(float) * n, size[0], f) != (size_t) size[0])
+        retv = RFPOS_GRID_ERR_IO;
+    }
+
+  // верхний уровень по приёмникам
+  for (i = 0; i < n; i++)
+    for (iz = 0, k = 0; iz < size[2]; iz += s)
+      for (iy = 0; iy < size[1]; iy += s)
+        for (ix = 0; ix < size[0]; ix += s, k++)
+          rt[i * nt + k] = rfpos_grid_range(&hdr, m, ix, iy, iz, i);
+  if (!retv && fwrite(rt, sizeof(float) * nt, n, f) != (size_t) n)
+    retv = RFPOS_GRID_ERR_IO;
+
+  if (fclose(f) != 0 && !retv)
+    retv = RFPOS_GRID_ERR_IO;
+  la_free(rt);
+  la_free(row);
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+// отобразить файл сетки в память (без перестроения)
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_GRID_ERR_*)
+int rfpos_grid_open(
+  rfpos_grid_t *self, // структура данных сетки
+  const char *fname,  // имя файла
+  int d,              // размерность координат (2 или 3)
+  int n,              // число приёмников
+  const double *m)    // таблица координат приёмников [n][d] или NULL
+{
+  int i, j, fd;
+  struct stat st;
+  const rfpos_grid_hdr_t *hdr;
+
+  self->map = (void*) 0;
+  self->len = 0;
+
+  fd = open(fname, O_RDONLY);
+  if (fd < 0)
+    return RFPOS_GRID_ERR_IO;
+
+  if (fstat(fd, &st) < 0)
+  {
+    close(fd);
+    return RFPOS_GRID_ERR_IO;
+  }
+  if ((size_t) st.st_size < sizeof(rfpos_grid_hdr_t))
+  {
+    close(fd);
+    return RFPOS_GRID_ERR_FORMAT;
+  }
+
+  self->len = (size_t) st.st_size;
+  self->map = mmap((void*) 0, self->len, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // отображение остаётся действительным
+  if (self->map == MAP_FAILED)
+  {
+    self->map = (void*) 0;
+    return RFPOS_GRID_ERR_IO;
+  }
+
+  // проверить заголовок и размер файла
+  hdr = (const rfpos_grid_hdr_t*) self->map;
+  if (memcmp(hdr->magic, RFPOS_GRID_MAGIC, sizeof(hdr->magic)) != 0 ||
+      hdr->version != RFPOS_GRID_VERSION ||
+      hdr->d < 2 || hdr->d > RFPOS_D_MAX || hdr->n < 1 ||
+      !hdr->size[0] || !hdr->size[1] || !hdr->size[2] || !(hdr->step > 0.))
+  {
+    rfpos_grid_close(self);
+    return RFPOS_GRID_ERR_FORMAT;
+  }
+
+  self->d = hdr->d;
+  self->n = hdr->n;
+  self->step = hdr->step;
+  for (j = 0; j < 3; j++)
+  {
+    self->size[j] = hdr->size[j];
+    self->lo[j]   = hdr->lo[j];
+  }
+  self->top = rfpos_grid_top(self->size, self->tsize);
+  if (self->top != (int) hdr->top ||
+      rfpos_grid_len(self->d, self->n, self->size, self->tsize) != self->len)
+  {
+    rfpos_grid_close(self);
+    return RFPOS_GRID_ERR_FORMAT;
+  }
+
+  self->s = (const double*) (hdr + 1);
+  self->r = (const float*) (self->s + self->n * self->d);
+  self->rt = self->r + (size_t) self->n *
+             self->size[0] * self->size[1] * self->size[2];
+
+  // сетка должна соответствовать расположению приёмников вызывающего
+  if (self->d != d || self->n != n)
+  {
+    rfpos_grid_close(self);
+    return RFPOS_GRID_ERR_LAYOUT;
+  }
+  for (i = 0; m && i < n * d; i++)
+    if (fabs(self->s[i] - m[i]) > RFPOS_GRID_TOL)
+    {
+      rfpos_grid_close(self);
+      return RFPOS_GRID_ERR_LAYOUT;
+    }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// закрыть отображение
+void rfpos_grid_close(rfpos_grid_t *self)
+{
+  if (self->map)
+    munmap(self->map, self->len);
+  self->map = (void*) 0;
+  self->len = 0;
+}
+//----------------------------------------------------------------------------
+// рассогласование дальностей узла i и импульса с точностью до общего
+// сдвига: sum(e^2) - sum(e)^2 / n, e[k] = |X - S[k]| - |X - S[0]| - dd[k]
+// (разности относительно первого приёмника сохраняют точность суммы)
+static double rfpos_grid_cost(
+  const rfpos_grid_t *self, // структура данных сетки
+  const int *i,             // номер узла по осям [3]
+  int n,                    // число приёмников импульса
+  const int *idx,           // индексы приёмников [n]
+  const double *dd,         // дальности C * (t[k] - t[0]) [n]
+  double rn)                // 1 / n
+{
+  int k;
+  double s = 0., s2 = 0., e, r0;
+  const float *r = self->r + (((size_t) i[2] * self->size[1] + i[1]) *
+                              self->size[0] + i[0]) * self->n;
+
+  r0 = (double) r[idx[0]];
+  for (k = 1; k < n; k++)
+  {
+    e = (double) r[idx[k]] - r0 - dd[k];
+    s  += e;
+    s2 += e * e;
+  }
+
+  return s2 - s * s * rn;
+}
+//----------------------------------------------------------------------------
+// вставить узел в упорядоченный список кандидатов (повторы отбрасываются)
+static void rfpos_grid_insert(
+  rfpos_grid_cand_t *c, // список кандидатов [RFPOS_GRID_K]
+  int *cnt,             // текущее число кандидатов
+  const int *i,         // номер узла по осям [3]
+  double f)             // рассогласование
+{
+  int k, l;
+
+  if (*cnt == RFPOS_GRID_K && !(f < c[*cnt - 1].f))
+    return;
+  for (k = 0; k < *cnt; k++)
+    if (c[k].i[0] == i[0] && c[k].i[1] == i[1] && c[k].i[2] == i[2])
+      return;
+
+  if (*cnt < RFPOS_GRID_K)
+    (*cnt)++;
+
+  for (k = *cnt - 1; k > 0 && !(c[k - 1].f <= f); k--)
+    c[k] = c[k - 1];
+  for (l = 0; l < 3; l++)
+    c[k].i[l] = i[l];
+  c[k].f = f;
+}
+//----------------------------------------------------------------------------
+// узел сетки, дальности которого лучше всего согласуются с временными
+// метками импульса
+// (в случае успеха возвращается 0, ошибки - отрицательный код ошибки)
+int rfpos_grid_guess(
+  const rfpos_grid_t *self, // структура данных сетки
+  int n,                    // число приёмников, принявших сигнал
+                            // (1 < n <= RFPOS_GRID_N)
+  const int *idx,           // индексы приёмников в таблице [n]
+  const double *t,          // временные метки приёма сигнала [n]
+  double *p)                // координаты узла [d]
+{
+  int i[3], j, k, l, o, b, nb, nt, cnt = 0, nc, s = self->top, cube = 1;
+  double f, rn, dd[RFPOS_GRID_N];
+  double s1[RFPOS_GRID_BLK], s2[RFPOS_GRID_BLK];
+  rfpos_grid_cand_t c[RFPOS_GRID_K], prev[RFPOS_GRID_K];
+
+  if (!self->map || n < 2 || n > RFPOS_GRID_N)
+    return RFPOS_GRID_ERR_ARG;
+
+  for (k = 0; k < n; k++)
+  {
+    if (idx[k] < 0 || idx[k] >= self->n)
+      return RFPOS_GRID_ERR_ARG;
+    dd[k] = (t[k] - t[0]) * RFPOS_C; // секунды -> метры
+  }
+  rn = 1. / (double) n;
+
+  // верхний уровень: полный перебор блоками узлов (дальности верхнего
+  // уровня хранятся по приёмникам, поэтому внутренний цикл по узлам
+  // векторизуется компилятором)
+  nt = self->tsize[0] * self->tsize[1] * self->tsize[2];
+  for (b = 0; b < nt; b += RFPOS_GRID_BLK)
+  {
+    const float *r0 = self->rt + (size_t) idx[0] * nt + b;
+    nb = nt - b < RFPOS_GRID_BLK ? nt - b : RFPOS_GRID_BLK;
+
+    for (l = 0; l < nb; l++)
+      s1[l] = s2[l] = 0.;
+    for (k = 1; k < n; k++)
+    {
+      const float *rk = self->rt + (size_t) idx[k] * nt + b;
+      double q = dd[k];
+      for (l = 0; l < nb; l++)
+      {
+        double e = (double) rk[l] - (double) r0[l] - q;
+        s1[l] += e;
+        s2[l] += e * e;
+      }
+    }
+
+    for (l = 0; l < nb; l++)
+    {
+      f = s2[l] - s1[l] * s1[l] * rn;
+      if (cnt == RFPOS_GRID_K && !(f < c[cnt - 1].f))
+        continue;
+      o = b + l;
+      i[0] = (o % self->tsize[0]) * s;
+      o /= self->tsize[0];
+      i[1] = (o % self->tsize[1]) * s;
+      i[2] = (o / self->tsize[1]) * s;
+      rfpos_grid_insert(c, &cnt, i, f);
+    }
+  }
+
+  // следующие уровни: соседи кандидатов с вдвое меньшим шагом
+  for (j = 0; j < self->d; j++)
+    cube *= 3;
+  while (s > 1)
+  {
+    s >>= 1;
+    nc = cnt;
+    for (k = 0; k < nc; k++)
+      prev[k] = c[k];
+    cnt = 0;
+
+    for (k = 0; k < nc; k++)
+      for (o = 0; o < cube; o++)
+      {
+        int q = o, ok = 1;
+        for (j = 0; j < 3; j++)
+        {
+          i[j] = prev[k].i[j];
+          if (j < self->d)
+          {
+            i[j] += (q % 3 - 1) * s;
+            q /= 3;
+          }
+          if (i[j] < 0 || i[j] >= self->size[j]) ok = 0;
+        }
+        if (!ok) continue;
+        f = o == cube / 2 ? prev[k].f :
+                            rfpos_grid_cost(self, i, n, idx, dd, rn);
+        rfpos_grid_insert(c, &cnt, i, f);
+      }
+  }
+
+  for (j = 0; j < self->d; j++)
+    p[j] = self->lo[j] + c[0].i[j] * self->step;
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// rfpos_calc() с исходной точкой из сетки
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_grid(
+  rfpos_t *self,             // структура данных компонента
+  const rfpos_grid_t *grid,  // сетка
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const int *idx,  // индексы приёмников в таблице сетки [n]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  double p[RFPOS_D_MAX];
+  int ok = rfpos_grid_guess(grid, n, idx, t, p) == 0;
+
+  return rfpos_calc_sub(self, (const rfpos_sub_t*) 0, it, e, grid->d, n,
+                        grid->s, idx, t, (const double*) 0,
+                        ok ? p : (const double*) 0, t0, r);
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_grid.c" ***/
@@ -0,0 +1,137 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (сетка ожидаемых дальностей для выбора исходной точки поиска)
+ * Version: 0.1b
+ * File: "rfpos_grid.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_GRID_H
+#define RFPOS_GRID_H
+//----------------------------------------------------------------------------
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t
+#include "rfpos.h"  // `rfpos_t`, RFPOS_D_MAX
+//----------------------------------------------------------------------------
+// сигнатура и версия формата файла сетки
+#define RFPOS_GRID_MAGIC   "RFPOSGRD"
+#define RFPOS_GRID_VERSION 1
+//----------------------------------------------------------------------------
+// максимальное число узлов верхнего (самого грубого) уровня поиска и
+// число кандидатов, уточняемых на каждом следующем уровне
+#define RFPOS_GRID_TOP 4096
+#define RFPOS_GRID_K   4
+//----------------------------------------------------------------------------
+// максимальное число приёмников импульса в rfpos_grid_guess() и число
+// узлов верхнего уровня в блоке просмотра
+#define RFPOS_GRID_N   256
+#define RFPOS_GRID_BLK 256
+//----------------------------------------------------------------------------
+// коды ошибок функций модуля
+#define RFPOS_GRID_ERR_ARG    -1 // недопустимые параметры
+#define RFPOS_GRID_ERR_IO     -2 // ошибка открытия/записи/отображения файла
+#define RFPOS_GRID_ERR_FORMAT -3 // неизвестный формат или версия файла
+#define RFPOS_GRID_ERR_LAYOUT -4 // файл построен для другого расположения
+                                 // приёмников
+#define RFPOS_GRID_ERR_MEM    -5 // нет памяти
+//----------------------------------------------------------------------------
+// заголовок файла сетки (72 байта, порядок байт машины); за ним следуют
+// координаты приёмников double [n][d], дальности от узлов до приёмников
+// float [size[2]][size[1]][size[0]][n] (по узлу - n дальностей подряд) и
+// копия верхнего уровня поиска - узлов с номерами, кратными top, по
+// приёмникам float [n][tsize[2]][tsize[1]][tsize[0]] (верхний уровень
+// просматривается целиком, "структура массивов" для векторизации)
+typedef struct {
+  char magic[8];     // RFPOS_GRID_MAGIC (без завершающего нуля)
+  uint32_t version;  // RFPOS_GRID_VERSION
+  uint32_t d;        // размерность координат (2 или 3)
+  uint32_t n;        // число приёмников
+  uint32_t size[3];  // число узлов по осям (size[2] = 1 при d = 2)
+  uint32_t top;      // шаг верхнего уровня поиска [узлов] (степень двойки)
+  uint32_t reserved; // 0
+  double lo[3];      // координаты первого узла [м]
+  double step;       // шаг сетки [м]
+} rfpos_grid_hdr_t;
+//----------------------------------------------------------------------------
+// сетка, отображённая в память (только чтение, разделяется потоками)
+typedef struct {
+  void *map;        // отображение файла
+  size_t len;       // длина отображения [байт]
+  int d;            // размерность координат (2 или 3)
+  int n;            // число приёмников
+  int size[3];      // число узлов по осям
+  int top;          // шаг верхнего уровня поиска [узлов]
+  int tsize[3];     // число узлов верхнего уровня по осям
+  double lo[3];     // координаты первого узла [м]
+  double step;      // шаг сетки [м]
+  const double *s;  // координаты приёмников [n][d]
+  const float *r;   // дальности от узлов до приёмников [узлы][n]
+  const float *rt;  // дальности узлов верхнего уровня [n][узлы]
+} rfpos_grid_t;
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// построить сетку над параллелепипедом [lo, hi] и записать в файл
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_GRID_ERR_*)
+int rfpos_grid_build(
+  const char *fname, // имя файла
+  int d,             // размерность координат (2 или 3)
+  int n,             // число приёмников
+  const double *m,   // таблица координат приёмников [n][d]
+  const double *lo,  // нижняя граница области [d]
+  const double *hi,  // верхняя граница области [d]
+  double step);      // шаг сетки [м]
+//----------------------------------------------------------------------------
+// отобразить файл сетки в память (без перестроения); если задана таблица
+// координат приёмников, она должна совпадать с записанной в файле
+// (в случае ошибки возвращается отрицательный код ошибки RFPOS_GRID_ERR_*)
+int rfpos_grid_open(
+  rfpos_grid_t *self, // структура данных сетки
+  const char *fname,  // имя файла
+  int d,              // размерность координат (2 или 3)
+  int n,              // число приёмников
+  const double *m);   // таблица координат приёмников [n][d] или NULL
+//----------------------------------------------------------------------------
+// закрыть отображение
+void rfpos_grid_close(rfpos_grid_t *self);
+//----------------------------------------------------------------------------
+// узел сетки, дальности которого лучше всего согласуются с временными
+// метками импульса (с точностью до общего сдвига): поиск от грубого уровня
+// (не более RFPOS_GRID_TOP узлов) к точному с RFPOS_GRID_K кандидатами
+// (в случае успеха возвращается 0 и координаты узла записываются в p,
+// ошибки - отрицательный код ошибки)
+int rfpos_grid_guess(
+  const rfpos_grid_t *self, // структура данных сетки
+  int n,                    // число приёмников, принявших сигнал
+                            // (1 < n <= RFPOS_GRID_N)
+  const int *idx,           // индексы приёмников в таблице [n]
+  const double *t,          // временные метки приёма сигнала [n]
+  double *p);               // координаты узла [d]
+//----------------------------------------------------------------------------
+// rfpos_calc() с исходной точкой из сетки (холодный старт без априорных
+// сведений о положении передатчика)
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_grid(
+  rfpos_t *self,             // структура данных компонента
+  const rfpos_grid_t *grid,  // сетка
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const int *idx,  // индексы приёмников в таблице сетки [n]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_GRID_H
+
+/*** end of "rfpos_grid.h" ***/
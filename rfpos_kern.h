@@ -0,0 +1,589 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (шаблон векторного ядра совмещенного прохода по приёмникам)
+ * Version: 0.1b
+ * File: "rfpos_kern.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+// Файл включается в "rfpos_simd.c" несколько раз, перед каждым включением
+// должны быть определены:
+//   RFPOS_KERN(x)   - формирование имени (например rfpos_fw_avx2##x)
+//   RFPOS_KERN_ATTR - атрибуты функций (например target("avx2"))
+//   RFPOS_KERN_SIZE - размер вектора в байтах (16, 32 или 64)
+//   RFPOS_KERN_SQRT(v) - поэлементный квадратный корень вектора
+// и, при необходимости:
+//   RFPOS_KERN_T    - тип элемента входных данных (по умолчанию la_float_t)
+//   RFPOS_KERN_F32  - собрать только ядра совмещенного прохода типа
+//                     `rfpos_fwf_t` (RFPOS_KERN_T = float, без ядер
+//                     разностного прохода, прохода без нормальной
+//                     матрицы и оценки гипотез и без
+//                     RFPOS_KERN_SQRT)
+// Определяются функции RFPOS_KERN(_2) и RFPOS_KERN(_3) типа `rfpos_fw_t`,
+// RFPOS_KERN(_td2), RFPOS_KERN(_td3) типа `rfpos_td_t`, RFPOS_KERN(_gr2),
+// RFPOS_KERN(_gr3) типа `rfpos_gr_t` и RFPOS_KERN(_sc2), RFPOS_KERN(_sc3)
+// типа `rfpos_sc_t` для d=2 и d=3.
+// Приёмники обрабатываются блоками по RFPOS_KERN_SIZE / sizeof(RFPOS_KERN_T)
+// штук, остаток - скалярным циклом.
+
+//----------------------------------------------------------------------------
+#ifndef RFPOS_KERN_T
+#  define RFPOS_KERN_T la_float_t
+#endif
+#define RFPOS_KERN_W ((int) (RFPOS_KERN_SIZE / sizeof(RFPOS_KERN_T)))
+//----------------------------------------------------------------------------
+// векторный тип
+typedef RFPOS_KERN_T RFPOS_KERN(_v)
+  __attribute__((vector_size(RFPOS_KERN_SIZE)));
+//----------------------------------------------------------------------------
+// тело ядра (подставляется с константными d, wt и kc)
+RFPOS_KERN_ATTR __attribute__((always_inline))
+static inline double RFPOS_KERN(_d)(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к невязке добавляются постоянные слагаемые
+  const double *x,        // точка (x0, y0, z0, d0) [d+1]
+  RFPOS_KERN_T *const *y, // столбцы входных данных [d+1][n]
+  const RFPOS_KERN_T *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const RFPOS_KERN_T *cf, // постоянные слагаемые невязки [n] (при kc = 1)
+  double *a,              // нижний треугольник W^(T) * W построчно
+  double *b)              // вектор W^(T) * F [d+1]
+{
+  typedef RFPOS_KERN(_v) v_t;
+  typedef __typeof__(((v_t) {0}) < ((v_t) {0})) m_t; // тип маски сравнения
+  int i, j, k, l, u = d + 1;
+  const v_t z = {0}, qmin = z + (RFPOS_KERN_T) (RFPOS_W_QMIN * RFPOS_W_QMIN);
+  v_t xv[RFPOS_U_MAX], w[RFPOS_U_MAX], v[RFPOS_U_MAX], f, q, yv, c;
+  v_t s[RFPOS_U_MAX * (RFPOS_U_MAX + 1) / 2], fm = z;
+  m_t mk;
+  double fs;
+
+  for (j = 0; j < u; j++)
+  {
+    xv[j] = z + (RFPOS_KERN_T) x[j];
+    v[j] = z;
+  }
+  for (k = 0; k < u * (u + 1) / 2; k++)
+    s[k] = z;
+
+  // векторная часть: RFPOS_KERN_W приёмников за одну команду
+  for (i = 0; i + RFPOS_KERN_W <= n; i += RFPOS_KERN_W)
+  {
+    f = z;
+    for (j = 0; j < d; j++)
+    {
+      __builtin_memcpy(&yv, y[j] + i, sizeof(v_t)); // без выравнивания
+      q = xv[j] - yv;
+      w[j] = q + q;
+      f += q * q;
+    }
+    __builtin_memcpy(&yv, y[d] + i, sizeof(v_t));
+    q = xv[d] - yv;
+    w[d] = -(q + q);
+    f -= q * q;
+    if (kc)
+    {
+      __builtin_memcpy(&yv, cf + i, sizeof(v_t));
+      f += yv;
+    }
+
+    if (wt)
+    { // c = sw / max(q^2, qmin) (выбор по маске без ветвлений)
+      q *= q;
+      mk = q < qmin;
+      q = (v_t) (((m_t) q & ~mk) | ((m_t) qmin & mk));
+      __builtin_memcpy(&yv, sw + i, sizeof(v_t));
+      c = yv / q;
+      fm += c * f * f;
+      for (j = 0, l = 0; j < u; j++)
+      {
+        q = c * w[j];
+        for (k = 0; k <= j; k++, l++)
+          s[l] += q * w[k];
+        v[j] += q * f;
+      }
+      continue;
+    }
+
+    fm += f * f;
+    for (j = 0, l = 0; j < u; j++)
+    {
+      for (k = 0; k <= j; k++, l++)
+        s[l] += w[j] * w[k];
+      v[j] += w[j] * f;
+    }
+  }
+
+  // горизонтальное суммирование
+  fs = 0.;
+  for (k = 0; k < RFPOS_KERN_W; k++)
+    fs += fm[k];
+  for (j = 0; j < u; j++)
+  {
+    b[j] = 0.;
+    for (k = 0; k < RFPOS_KERN_W; k++)
+      b[j] += v[j][k];
+  }
+  for (l = 0; l < u * (u + 1) / 2; l++)
+  {
+    a[l] = 0.;
+    for (k = 0; k < RFPOS_KERN_W; k++)
+      a[l] += s[l][k];
+  }
+
+  // скалярный остаток
+  for (; i < n; i++)
+  {
+    double ws[RFPOS_U_MAX], fi = 0., qi, ci = 1.;
+    for (j = 0; j < d; j++)
+    {
+      qi = x[j] - y[j][i];
+      ws[j] = 2. * qi;
+      fi += qi * qi;
+    }
+    qi = x[d] - y[d][i];
+    ws[d] = -2. * qi;
+    fi -= qi * qi;
+    if (kc) fi += cf[i];
+
+    if (wt)
+    {
+      qi *= qi;
+      if (qi < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        qi = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      ci = sw[i] / qi;
+    }
+
+    fs += ci * fi * fi;
+    for (j = 0, l = 0; j < u; j++)
+    {
+      qi = ci * ws[j];
+      for (k = 0; k <= j; k++, l++)
+        a[l] += qi * ws[k];
+      b[j] += qi * fi;
+    }
+  }
+
+  return fs;
+}
+//----------------------------------------------------------------------------
+// ядро для d=2
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_2)(
+  int n, const double *x, RFPOS_KERN_T *const *y, const RFPOS_KERN_T *sw,
+  const RFPOS_KERN_T *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_d)(n, 2, 1, 1, x, y, sw, cf, a, b) :
+                RFPOS_KERN(_d)(n, 2, 0, 1, x, y, sw, cf, a, b);
+  return sw ? RFPOS_KERN(_d)(n, 2, 1, 0, x, y, sw, cf, a, b) :
+              RFPOS_KERN(_d)(n, 2, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// ядро для d=3
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_3)(
+  int n, const double *x, RFPOS_KERN_T *const *y, const RFPOS_KERN_T *sw,
+  const RFPOS_KERN_T *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_d)(n, 3, 1, 1, x, y, sw, cf, a, b) :
+                RFPOS_KERN(_d)(n, 3, 0, 1, x, y, sw, cf, a, b);
+  return sw ? RFPOS_KERN(_d)(n, 3, 1, 0, x, y, sw, cf, a, b) :
+              RFPOS_KERN(_d)(n, 3, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+#ifndef RFPOS_KERN_F32
+// тело ядра разностного (TDOA) прохода (подставляется с константными d,
+// wt и kc); строка (u, 1) и невязка e = |X - S| - d (см. `rfpos_td_t`)
+RFPOS_KERN_ATTR __attribute__((always_inline))
+static inline double RFPOS_KERN(_tdd)(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к квадрату дальности добавляются cf[i]
+  const double *x,      // точка (x0, y0, z0) [d]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  const la_float_t *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const la_float_t *cf, // постоянные слагаемые [n] (при kc = 1)
+  double *a,            // нижний треугольник построчно
+  double *b)            // вектор [d+1]
+{
+  typedef RFPOS_KERN(_v) v_t;
+  typedef __typeof__(((v_t) {0}) < ((v_t) {0})) m_t; // тип маски сравнения
+  int i, j, k, l, u = d + 1;
+  const v_t z = {0}, one = z + (la_float_t) 1.;
+  const v_t qmin = z + (la_float_t) RFPOS_W_QMIN;
+  v_t xv[RFPOS_D_MAX], w[RFPOS_U_MAX], v[RFPOS_U_MAX], f, q, yv, c;
+  v_t s[RFPOS_U_MAX * (RFPOS_U_MAX + 1) / 2], fm = z;
+  m_t mk;
+  double fs;
+
+  for (j = 0; j < d; j++)
+    xv[j] = z + (la_float_t) x[j];
+  for (j = 0; j < u; j++)
+    v[j] = z;
+  for (k = 0; k < u * (u + 1) / 2; k++)
+    s[k] = z;
+
+  // векторная часть: RFPOS_KERN_W приёмников за одну команду
+  for (i = 0; i + RFPOS_KERN_W <= n; i += RFPOS_KERN_W)
+  {
+    f = z;
+    for (j = 0; j < d; j++)
+    {
+      __builtin_memcpy(&yv, y[j] + i, sizeof(v_t)); // без выравнивания
+      w[j] = xv[j] - yv;
+      f += w[j] * w[j];
+    }
+    if (kc)
+    {
+      __builtin_memcpy(&yv, cf + i, sizeof(v_t));
+      f += yv;
+    }
+    f = RFPOS_KERN_SQRT(f); // дальность |X - S|
+
+    // единичный вектор u (дальность не меньше RFPOS_W_QMIN)
+    mk = f < qmin;
+    q = one / (v_t) (((m_t) f & ~mk) | ((m_t) qmin & mk));
+    for (j = 0; j < d; j++)
+      w[j] *= q;
+    w[d] = one;
+
+    __builtin_memcpy(&yv, y[d] + i, sizeof(v_t));
+    f -= yv; // невязка e
+
+    if (wt)
+    {
+      __builtin_memcpy(&c, sw + i, sizeof(v_t));
+      fm += c * f * f;
+      for (j = 0, l = 0; j < u; j++)
+      {
+        q = c * w[j];
+        for (k = 0; k <= j; k++, l++)
+          s[l] += q * w[k];
+        v[j] += q * f;
+      }
+      continue;
+    }
+
+    fm += f * f;
+    for (j = 0, l = 0; j < u; j++)
+    {
+      for (k = 0; k <= j; k++, l++)
+        s[l] += w[j] * w[k];
+      v[j] += w[j] * f;
+    }
+  }
+
+  // горизонтальное суммирование
+  fs = 0.;
+  for (k = 0; k < RFPOS_KERN_W; k++)
+    fs += fm[k];
+  for (j = 0; j < u; j++)
+  {
+    b[j] = 0.;
+    for (k = 0; k < RFPOS_KERN_W; k++)
+      b[j] += v[j][k];
+  }
+  for (l = 0; l < u * (u + 1) / 2; l++)
+  {
+    a[l] = 0.;
+    for (k = 0; k < RFPOS_KERN_W; k++)
+      a[l] += s[l][k];
+  }
+
+  // скалярный остаток
+  for (; i < n; i++)
+  {
+    double ws[RFPOS_U_MAX], fi = 0., qi, ci = wt ? sw[i] : 1.;
+    for (j = 0; j < d; j++)
+    {
+      ws[j] = x[j] - y[j][i];
+      fi += ws[j] * ws[j];
+    }
+    if (kc) fi += cf[i];
+    fi = sqrt(fi);
+    qi = 1. / (fi < RFPOS_W_QMIN ? RFPOS_W_QMIN : fi);
+    for (j = 0; j < d; j++)
+      ws[j] *= qi;
+    ws[d] = 1.;
+    fi -= y[d][i];
+
+    fs += ci * fi * fi;
+    for (j = 0, l = 0; j < u; j++)
+    {
+      qi = ci * ws[j];
+      for (k = 0; k <= j; k++, l++)
+        a[l] += qi * ws[k];
+      b[j] += qi * fi;
+    }
+  }
+
+  return fs;
+}
+//----------------------------------------------------------------------------
+// ядро разностного прохода для d=2
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_td2)(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_tdd)(n, 2, 1, 1, x, y, sw, cf, a, b) :
+                RFPOS_KERN(_tdd)(n, 2, 0, 1, x, y, sw, cf, a, b);
+  return sw ? RFPOS_KERN(_tdd)(n, 2, 1, 0, x, y, sw, cf, a, b) :
+              RFPOS_KERN(_tdd)(n, 2, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// ядро разностного прохода для d=3
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_td3)(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_tdd)(n, 3, 1, 1, x, y, sw, cf, a, b) :
+                RFPOS_KERN(_tdd)(n, 3, 0, 1, x, y, sw, cf, a, b);
+  return sw ? RFPOS_KERN(_tdd)(n, 3, 1, 0, x, y, sw, cf, a, b) :
+              RFPOS_KERN(_tdd)(n, 3, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// тело ядра прохода без нормальной матрицы (подставляется с константными
+// d, wt и kc): только невязка и W^(T) * F (см. `rfpos_gr_t`)
+RFPOS_KERN_ATTR __attribute__((always_inline))
+static inline double RFPOS_KERN(_grd)(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к невязке добавляются постоянные слагаемые
+  const double *x,      // точка (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  const la_float_t *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const la_float_t *cf, // постоянные слагаемые невязки [n] (при kc = 1)
+  double *b)            // вектор W^(T) * F [d+1]
+{
+  typedef RFPOS_KERN(_v) v_t;
+  typedef __typeof__(((v_t) {0}) < ((v_t) {0})) m_t; // тип маски сравнения
+  int i, j, k, u = d + 1;
+  const v_t z = {0}, qmin = z + (la_float_t) (RFPOS_W_QMIN * RFPOS_W_QMIN);
+  v_t xv[RFPOS_U_MAX], w[RFPOS_U_MAX], v[RFPOS_U_MAX], f, q, yv, fm = z;
+  m_t mk;
+  double fs;
+
+  for (j = 0; j < u; j++)
+  {
+    xv[j] = z + (la_float_t) x[j];
+    v[j] = z;
+  }
+
+  // векторная часть: RFPOS_KERN_W приёмников за одну команду
+  for (i = 0; i + RFPOS_KERN_W <= n; i += RFPOS_KERN_W)
+  {
+    f = z;
+    for (j = 0; j < d; j++)
+    {
+      __builtin_memcpy(&yv, y[j] + i, sizeof(v_t)); // без выравнивания
+      q = xv[j] - yv;
+      w[j] = q + q;
+      f += q * q;
+    }
+    __builtin_memcpy(&yv, y[d] + i, sizeof(v_t));
+    q = xv[d] - yv;
+    w[d] = -(q + q);
+    f -= q * q;
+    if (kc)
+    {
+      __builtin_memcpy(&yv, cf + i, sizeof(v_t));
+      f += yv;
+    }
+
+    if (wt)
+    { // c * F, где c = sw / max(q^2, qmin)
+      q *= q;
+      mk = q < qmin;
+      q = (v_t) (((m_t) q & ~mk) | ((m_t) qmin & mk));
+      __builtin_memcpy(&yv, sw + i, sizeof(v_t));
+      yv = yv / q * f;
+      fm += yv * f;
+    }
+    else
+    {
+      yv = f;
+      fm += f * f;
+    }
+    for (j = 0; j < u; j++)
+      v[j] += w[j] * yv;
+  }
+
+  // горизонтальное суммирование
+  fs = 0.;
+  for (k = 0; k < RFPOS_KERN_W; k++)
+    fs += fm[k];
+  for (j = 0; j < u; j++)
+  {
+    b[j] = 0.;
+    for (k = 0; k < RFPOS_KERN_W; k++)
+      b[j] += v[j][k];
+  }
+
+  // скалярный остаток
+  for (; i < n; i++)
+  {
+    double ws[RFPOS_U_MAX], fi = 0., qi, ci = 1.;
+    for (j = 0; j < d; j++)
+    {
+      qi = x[j] - y[j][i];
+      ws[j] = 2. * qi;
+      fi += qi * qi;
+    }
+    qi = x[d] - y[d][i];
+    ws[d] = -2. * qi;
+    fi -= qi * qi;
+    if (kc) fi += cf[i];
+
+    if (wt)
+    {
+      qi *= qi;
+      if (qi < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        qi = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      ci = sw[i] / qi;
+    }
+
+    fs += ci * fi * fi;
+    for (j = 0; j < u; j++)
+      b[j] += ci * ws[j] * fi;
+  }
+
+  return fs;
+}
+//----------------------------------------------------------------------------
+// ядро прохода без нормальной матрицы для d=2
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_gr2)(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_grd)(n, 2, 1, 1, x, y, sw, cf, b) :
+                RFPOS_KERN(_grd)(n, 2, 0, 1, x, y, sw, cf, b);
+  return sw ? RFPOS_KERN(_grd)(n, 2, 1, 0, x, y, sw, cf, b) :
+              RFPOS_KERN(_grd)(n, 2, 0, 0, x, y, sw, cf, b);
+}
+//----------------------------------------------------------------------------
+// ядро прохода без нормальной матрицы для d=3
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_gr3)(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *b)
+{
+  if (cf)
+    return sw ? RFPOS_KERN(_grd)(n, 3, 1, 1, x, y, sw, cf, b) :
+                RFPOS_KERN(_grd)(n, 3, 0, 1, x, y, sw, cf, b);
+  return sw ? RFPOS_KERN(_grd)(n, 3, 1, 0, x, y, sw, cf, b) :
+              RFPOS_KERN(_grd)(n, 3, 0, 0, x, y, sw, cf, b);
+}
+//----------------------------------------------------------------------------
+// тело ядра оценки гипотезы (подставляется с константным d)
+RFPOS_KERN_ATTR __attribute__((always_inline))
+static inline double RFPOS_KERN(_scd)(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  const double *x,      // гипотеза (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  double thr,           // порог невязки "своих" приёмников [м]
+  int *cnt)             // число "своих" приёмников
+{
+  typedef RFPOS_KERN(_v) v_t;
+  typedef __typeof__(((v_t) {0}) < ((v_t) {0})) m_t; // тип маски сравнения
+  int i, j, k;
+  const v_t z = {0}, t2 = z + (la_float_t) (thr * thr);
+  v_t xv[RFPOS_U_MAX], f, q, yv, cm = z;
+  m_t mk, cn = z < z; // нулевой счётчик
+  double cs, ri;
+
+  for (j = 0; j <= d; j++)
+    xv[j] = z + (la_float_t) x[j];
+
+  // векторная часть: невязка по дальности r = |X - S| + d0 - d
+  for (i = 0; i + RFPOS_KERN_W <= n; i += RFPOS_KERN_W)
+  {
+    f = z;
+    for (j = 0; j < d; j++)
+    {
+      __builtin_memcpy(&yv, y[j] + i, sizeof(v_t)); // без выравнивания
+      q = xv[j] - yv;
+      f += q * q;
+    }
+    __builtin_memcpy(&yv, y[d] + i, sizeof(v_t));
+    q = RFPOS_KERN_SQRT(f) + (xv[d] - yv);
+    q *= q;
+
+    // min(r^2, thr^2) и счётчик "своих" (маска равна -1)
+    mk = q <= t2;
+    cn -= mk;
+    cm += (v_t) (((m_t) q & mk) | ((m_t) t2 & ~mk));
+  }
+
+  // горизонтальное суммирование
+  cs = 0.;
+  *cnt = 0;
+  for (k = 0; k < RFPOS_KERN_W; k++)
+  {
+    cs += cm[k];
+    *cnt += (int) cn[k];
+  }
+
+  // скалярный остаток
+  for (; i < n; i++)
+  {
+    double fi = 0., qi;
+    for (j = 0; j < d; j++)
+    {
+      qi = x[j] - y[j][i];
+      fi += qi * qi;
+    }
+    ri = sqrt(fi) + x[d] - y[d][i];
+    ri *= ri;
+    if (ri <= thr * thr)
+    {
+      cs += ri;
+      (*cnt)++;
+    }
+    else
+      cs += thr * thr;
+  }
+
+  return cs;
+}
+//----------------------------------------------------------------------------
+// ядро оценки гипотезы для d=2
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_sc2)(
+  int n, const double *x, la_float_t *const *y, double thr, int *cnt)
+{
+  return RFPOS_KERN(_scd)(n, 2, x, y, thr, cnt);
+}
+//----------------------------------------------------------------------------
+// ядро оценки гипотезы для d=3
+RFPOS_KERN_ATTR
+static double RFPOS_KERN(_sc3)(
+  int n, const double *x, la_float_t *const *y, double thr, int *cnt)
+{
+  return RFPOS_KERN(_scd)(n, 3, x, y, thr, cnt);
+}
+#endif // !RFPOS_KERN_F32
+//----------------------------------------------------------------------------
+#undef RFPOS_KERN_W
+#undef RFPOS_KERN_T
+#undef RFPOS_KERN_F32
+#undef RFPOS_KERN
+#undef RFPOS_KERN_ATTR
+#undef RFPOS_KERN_SIZE
+#undef RFPOS_KERN_SQRT
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_kern.h" ***/
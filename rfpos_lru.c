@@ -0,0 +1,170 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (хеш-таблица с вытеснением LRU для кэшей меток и подмножеств)
+ * Version: 0.1b
+ * File: "rfpos_lru.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include <string.h> // memcpy()
+#include "la.h"     // la_malloc(), la_free()
+#include "rfpos_lru.h"
+//----------------------------------------------------------------------------
+// исключить ячейку i из списка LRU
+static void rfpos_lru_unlink(rfpos_lru_t *self, int i)
+{
+  rfpos_lru_node_t *e = RFPOS_LRU_NODE(self, i);
+
+  if (e->prev >= 0) RFPOS_LRU_NODE(self, e->prev)->next = e->next;
+  else              self->head = e->next;
+
+  if (e->next >= 0) RFPOS_LRU_NODE(self, e->next)->prev = e->prev;
+  else              self->tail = e->prev;
+}
+//----------------------------------------------------------------------------
+// поставить ячейку i в начало списка LRU
+static void rfpos_lru_link(rfpos_lru_t *self, int i)
+{
+  rfpos_lru_node_t *e = RFPOS_LRU_NODE(self, i);
+
+  e->prev = -1;
+  e->next = self->head;
+  if (self->head >= 0) RFPOS_LRU_NODE(self, self->head)->prev = i;
+  else                 self->tail = i;
+  self->head = i;
+}
+//----------------------------------------------------------------------------
+// удалить ключ из ячейки i со сдвигом следующих ячеек цепочки назад
+// (таблица остаётся без "надгробий")
+static void rfpos_lru_remove(rfpos_lru_t *self, int i)
+{
+  int j, k, mask = self->size - 1;
+  rfpos_lru_node_t *ei, *ej;
+
+  rfpos_lru_unlink(self, i);
+  RFPOS_LRU_NODE(self, i)->used = 0;
+  self->cnt--;
+
+  for (j = i;;)
+  {
+    j = (j + 1) & mask;
+    ej = RFPOS_LRU_NODE(self, j);
+    if (!ej->used)
+      return;
+
+    // ячейка j остаётся на месте, если её "родная" ячейка k лежит
+    // циклически в интервале (i, j]
+    k = ej->h & mask;
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+      continue;
+
+    // перенести ячейку j в i и поправить ссылки списка LRU
+    ei = RFPOS_LRU_NODE(self, i);
+    memcpy(ei, ej, self->es);
+    if (ei->prev >= 0) RFPOS_LRU_NODE(self, ei->prev)->next = i;
+    else               self->head = i;
+    if (ei->next >= 0) RFPOS_LRU_NODE(self, ei->next)->prev = i;
+    else               self->tail = i;
+    ej->used = 0;
+    i = j;
+  }
+}
+//----------------------------------------------------------------------------
+// инициализация таблицы, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_lru_init(
+  rfpos_lru_t *self, // структура данных таблицы
+  int max,           // максимальное число ключей
+  int es)            // размер ячейки [байт] (sizeof структуры ячейки)
+{
+  int i;
+
+  if (max < 1 || es < (int) sizeof(rfpos_lru_node_t))
+    return -1; // ошибка: недопустимый размер
+
+  // заполнение таблицы не более 3/4
+  for (self->size = 2; self->size * 3 < max * 4; self->size <<= 1);
+
+  self->max  = max;
+  self->cnt  = 0;
+  self->head = -1;
+  self->tail = -1;
+  self->es   = es;
+
+  self->e = (char*) la_malloc(es * self->size);
+  if (!self->e)
+    return -2; // ошибка: нет памяти
+
+  for (i = 0; i < self->size; i++)
+    RFPOS_LRU_NODE(self, i)->used = 0;
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_lru_free(rfpos_lru_t *self)
+{
+  la_free(self->e);
+  self->e = (char*) 0;
+  self->cnt = 0;
+}
+//----------------------------------------------------------------------------
+// найти ячейку ключа (или -1); найденная ячейка становится последней в LRU
+int rfpos_lru_find(
+  rfpos_lru_t *self,  // структура данных таблицы
+  unsigned h,         // хеш ключа
+  rfpos_lru_eq_t eq,  // сравнение ключей
+  const void *key)    // искомый ключ
+{
+  int mask = self->size - 1;
+  int i = h & mask;
+  rfpos_lru_node_t *e;
+
+  for (; (e = RFPOS_LRU_NODE(self, i))->used; i = (i + 1) & mask)
+  {
+    if (e->h != h || !eq(e, key))
+      continue;
+
+    if (self->head != i)
+    {
+      rfpos_lru_unlink(self, i);
+      rfpos_lru_link(self, i);
+    }
+    return i;
+  }
+
+  return -1;
+}
+//----------------------------------------------------------------------------
+// занять ячейку для нового ключа (при заполненной таблице вытесняется
+// давно не использованный ключ)
+int rfpos_lru_add(
+  rfpos_lru_t *self, // структура данных таблицы
+  unsigned h,        // хеш ключа
+  long *evict)       // счётчик вытесненных ключей
+{
+  int i, mask = self->size - 1;
+  rfpos_lru_node_t *e;
+
+  if (self->cnt >= self->max)
+  {
+    rfpos_lru_remove(self, self->tail);
+    (*evict)++;
+  }
+
+  // свободная ячейка ищется после вытеснения (сдвиг меняет цепочки)
+  for (i = h & mask; RFPOS_LRU_NODE(self, i)->used; i = (i + 1) & mask);
+
+  e = RFPOS_LRU_NODE(self, i);
+  e->h    = h;
+  e->used = 1;
+  rfpos_lru_link(self, i);
+  self->cnt++;
+
+  return i;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_lru.c" ***/
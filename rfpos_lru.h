@@ -0,0 +1,84 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (хеш-таблица с вытеснением LRU для кэшей меток и подмножеств)
+ * Version: 0.1b
+ * File: "rfpos_lru.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_LRU_H
+#define RFPOS_LRU_H
+//----------------------------------------------------------------------------
+// внутренний модуль "rfpos_tag.c" и "rfpos_site.c": хеш-таблица
+// с открытой адресацией (линейное пробирование), удалением со сдвигом
+// цепочки назад (без "надгробий") и списком LRU; ячейка - структура
+// вызывающего, начинающаяся с `rfpos_lru_node_t`; память фиксирована
+//----------------------------------------------------------------------------
+// служебная часть ячейки (первое поле структуры ячейки)
+typedef struct {
+  unsigned h;     // хеш ключа (rfpos_hash())
+  int used;       // 1 - ячейка занята
+  int prev, next; // соседи в списке LRU (индексы ячеек или -1)
+} rfpos_lru_node_t;
+//----------------------------------------------------------------------------
+// таблица
+typedef struct {
+  int size; // число ячеек таблицы (степень двойки)
+  int max;  // максимальное число ключей (не более 3/4 size)
+  int cnt;  // текущее число ключей
+  int head; // последний использованный ключ (или -1)
+  int tail; // давно не использованный ключ (или -1)
+  int es;   // размер ячейки [байт]
+  char *e;  // ячейки таблицы [size][es]
+} rfpos_lru_t;
+//----------------------------------------------------------------------------
+// служебная часть ячейки i
+#define RFPOS_LRU_NODE(t, i) \
+  ((rfpos_lru_node_t*) ((t)->e + (long) (i) * (t)->es))
+//----------------------------------------------------------------------------
+// сравнение ключа ячейки с искомым (1 - совпадает)
+typedef int (*rfpos_lru_eq_t)(const void *e, const void *key);
+//----------------------------------------------------------------------------
+// хеш 32-разрядного ключа (перемешивание бит, чтобы соседние номера не шли
+// подряд): общий для кэша меток, кэша подмножеств и нитей пула решателей
+static inline unsigned rfpos_hash(unsigned x)
+{
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+//----------------------------------------------------------------------------
+// инициализация таблицы, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_lru_init(
+  rfpos_lru_t *self, // структура данных таблицы
+  int max,           // максимальное число ключей
+  int es);           // размер ячейки [байт] (sizeof структуры ячейки)
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_lru_free(rfpos_lru_t *self);
+//----------------------------------------------------------------------------
+// найти ячейку ключа (или -1); найденная ячейка становится последней в LRU
+int rfpos_lru_find(
+  rfpos_lru_t *self,  // структура данных таблицы
+  unsigned h,         // хеш ключа
+  rfpos_lru_eq_t eq,  // сравнение ключей
+  const void *key);   // искомый ключ
+//----------------------------------------------------------------------------
+// занять ячейку для нового ключа (при заполненной таблице вытесняется
+// давно не использованный ключ); ячейка становится последней в LRU,
+// остальные поля заполняет вызывающий
+// (возвращается индекс ячейки; *evict увеличивается при вытеснении)
+int rfpos_lru_add(
+  rfpos_lru_t *self, // структура данных таблицы
+  unsigned h,        // хеш ключа
+  long *evict);      // счётчик вытесненных ключей
+//----------------------------------------------------------------------------
+#endif // RFPOS_LRU_H
+
+/*** end of "rfpos_lru.h" ***/
@@ -0,0 +1,396 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (многопоточный пул решателей с перехватом работы)
+ * Version: 0.1b
+ * File: "rfpos_pool.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include "rfpos_pool.h"
+#include "rfpos_lru.h" // rfpos_hash()
+//----------------------------------------------------------------------------
+// атомарные операции над счётчиками пула (GCC/Clang)
+#define RFPOS_POOL_ADD(p, v) __atomic_add_fetch((p), (v), __ATOMIC_SEQ_CST)
+#define RFPOS_POOL_GET(p)    __atomic_load_n((p), __ATOMIC_SEQ_CST)
+//----------------------------------------------------------------------------
+// положить нить на "низ" деки потока
+static void rfpos_pool_push(rfpos_worker_t *w, rfpos_strand_t *s)
+{
+  rfpos_pool_t *pool = w->pool;
+
+  pthread_mutex_lock(&w->lock);
+  w->q[(w->top + w->cnt) & (pool->strands - 1)] = s;
+  RFPOS_POOL_ADD(&w->cnt, 1);
+  pthread_mutex_unlock(&w->lock);
+
+  // разбудить спящий поток (если есть)
+  RFPOS_POOL_ADD(&pool->queued, 1);
+  if (RFPOS_POOL_GET(&pool->sleepers) > 0)
+  {
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+  }
+}
+//----------------------------------------------------------------------------
+// взять нить с "низа" (owner = 1) или с "верха" (owner = 0) деки потока
+static rfpos_strand_t *rfpos_pool_pop(rfpos_worker_t *w, int owner)
+{
+  rfpos_strand_t *s = (rfpos_strand_t*) 0;
+  int mask = w->pool->strands - 1;
+
+  if (RFPOS_POOL_GET(&w->cnt) == 0)
+    return s; // дека пуста (проверка без блокировки)
+
+  pthread_mutex_lock(&w->lock);
+  if (w->cnt && RFPOS_POOL_GET(&w->pool->edf))
+  { // самая ранняя по сроку нить деки - на место взятия
+    int i, k = owner ? w->cnt - 1 : 0, j = k;
+    for (i = 0; i < w->cnt; i++)
+    {
+      double a = w->q[(w->top + i) & mask]->tdl;
+      double b = w->q[(w->top + k) & mask]->tdl;
+      if (a > 0. && (b <= 0. || a < b))
+        k = i;
+    }
+    s = w->q[(w->top + k) & mask];
+    w->q[(w->top + k) & mask] = w->q[(w->top + j) & mask];
+    w->q[(w->top + j) & mask] = s;
+    s = (rfpos_strand_t*) 0;
+  }
+  if (w->cnt)
+  {
+    RFPOS_POOL_ADD(&w->cnt, -1);
+    if (owner)
+      s = w->q[(w->top + w->cnt) & mask];
+    else
+    {
+      s = w->q[w->top];
+      w->top = (w->top + 1) & mask;
+    }
+  }
+  pthread_mutex_unlock(&w->lock);
+
+  if (s)
+    RFPOS_POOL_ADD(&w->pool->queued, -1);
+
+  return s;
+}
+//----------------------------------------------------------------------------
+// решить одно задание в рабочем пространстве потока
+static void rfpos_pool_solve(rfpos_worker_t *w, rfpos_job_t *job)
+{
+  w->rfpos.tdl = job->tdl;
+  if (job->idx)
+  { // приёмники задаются индексами в общей таблице
+    rfpos_batch_t b;
+    b.k   = 1;
+    b.n   = &job->n;
+    b.idx = job->idx;
+    b.t   = job->t;
+    b.s   = job->s;
+    b.p   = job->p;
+    b.t0  = &job->t0;
+    b.r   = job->r;
+    b.st  = &job->st;
+    b.cov = job->cov;
+    b.tdl = (const double*) 0;
+    b.ord = (int*) 0;
+    rfpos_calc_batch(&w->rfpos, job->it, job->e, job->d, job->m, &b);
+  }
+  else if (job->n <= job->d)
+    job->st = RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+  else
+  {
+    job->st = rfpos_calc_w(&w->rfpos, job->it, job->e, job->d, job->n,
+                           job->m, job->t, job->s, job->p, &job->t0, job->r);
+    if (job->st >= 0 && job->cov)
+      rfpos_cov(&w->rfpos, job->cov);
+  }
+}
+//----------------------------------------------------------------------------
+// обработать все задания нити по порядку, затем освободить нить
+static void rfpos_pool_run(rfpos_worker_t *w, rfpos_strand_t *s)
+{
+  rfpos_pool_t *pool = w->pool;
+  rfpos_job_t *job, *next;
+
+  for (;;)
+  {
+    // забрать всю очередь нити целиком
+    pthread_mutex_lock(&s->lock);
+    job = s->head;
+    s->head = s->tail = (rfpos_job_t*) 0;
+    if (!job)
+      s->active = 0; // нить опустела - её снова можно ставить в деку
+    pthread_mutex_unlock(&s->lock);
+
+    if (!job)
+      return;
+
+    for (; job; job = next)
+    {
+      next = job->next; // после done() задание принадлежит вызывающему
+      rfpos_pool_solve(w, job);
+      w->solved++;
+      if (pool->done)
+        pool->done(job);
+
+      if (RFPOS_POOL_ADD(&pool->pending, -1) == 0)
+      { // все задания завершены
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+      }
+    }
+  }
+}
+//----------------------------------------------------------------------------
+// найти работу: своя дека, затем перехват у остальных потоков по кругу
+static rfpos_strand_t *rfpos_pool_find(rfpos_worker_t *w)
+{
+  rfpos_pool_t *pool = w->pool;
+  rfpos_strand_t *s;
+  int i;
+
+  s = rfpos_pool_pop(w, 1);
+  if (s)
+    return s;
+
+  for (i = 1; i < pool->threads; i++)
+  {
+    s = rfpos_pool_pop(&pool->w[(w->id + i) % pool->threads], 0);
+    if (s)
+    {
+      w->stolen++;
+      return s;
+    }
+  }
+
+  return s;
+}
+//----------------------------------------------------------------------------
+// функция рабочего потока
+static void *rfpos_pool_thread(void *arg)
+{
+  rfpos_worker_t *w = (rfpos_worker_t*) arg;
+  rfpos_pool_t *pool = w->pool;
+  rfpos_strand_t *s;
+  int stop;
+
+  for (;;)
+  {
+    s = rfpos_pool_find(w);
+    if (s)
+    {
+      rfpos_pool_run(w, s);
+      continue;
+    }
+
+    // работы нет - уснуть до появления новых нитей в деках
+    // (sleepers увеличивается до проверки queued, а rfpos_pool_push()
+    // увеличивает queued до проверки sleepers, поэтому сигнал не теряется)
+    pthread_mutex_lock(&pool->lock);
+    RFPOS_POOL_ADD(&pool->sleepers, 1);
+    while (!pool->stop && RFPOS_POOL_GET(&pool->queued) <= 0)
+      pthread_cond_wait(&pool->wake, &pool->lock);
+    RFPOS_POOL_ADD(&pool->sleepers, -1);
+    stop = pool->stop && RFPOS_POOL_GET(&pool->queued) <= 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (stop)
+      break;
+  }
+
+  return (void*) 0;
+}
+//----------------------------------------------------------------------------
+// инициализация пула, запуск рабочих потоков
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_pool_init(
+  rfpos_pool_t *self, // структура данных пула
+  int threads,        // число рабочих потоков (1...RFPOS_POOL_MAX)
+  int strands,        // число нитей (округляется вверх до степени двойки,
+                      // 0 - выбрать автоматически)
+  int d,              // максимальная размерность координат (2 или 3)
+  int n,              // максимальное число приёмников
+  rfpos_done_t done)  // функция завершения задания или NULL
+{
+  int i, k;
+
+  if (threads < 1 || threads > RFPOS_POOL_MAX)
+    return -1; // ошибка: недопустимое число потоков
+
+  if (strands <= 0)
+    strands = threads * 16;
+  for (k = 1; k < strands; k <<= 1);
+
+  self->threads  = threads;
+  self->strands  = k;
+  self->done     = done;
+  self->sleepers = 0;
+  self->queued   = 0;
+  self->pending  = 0;
+  self->stop     = 0;
+  self->rr       = 0;
+  self->edf      = 0;
+
+  self->s = (rfpos_strand_t*) la_malloc(sizeof(rfpos_strand_t) * k);
+  self->w = (rfpos_worker_t*) la_malloc(sizeof(rfpos_worker_t) * threads);
+  if (!self->s || !self->w)
+  {
+    la_free(self->s);
+    la_free(self->w);
+    return -2; // ошибка: нет памяти
+  }
+
+  pthread_mutex_init(&self->lock, NULL);
+  pthread_cond_init(&self->wake, NULL);
+  pthread_cond_init(&self->idle, NULL);
+
+  for (i = 0; i < k; i++)
+  {
+    rfpos_strand_t *s = self->s + i;
+    pthread_mutex_init(&s->lock, NULL);
+    s->head = s->tail = (rfpos_job_t*) 0;
+    s->active = 0;
+  }
+
+  for (i = 0; i < threads; i++)
+  {
+    rfpos_worker_t *w = self->w + i;
+    w->pool   = self;
+    w->id     = i;
+    w->top    = 0;
+    w->cnt    = 0;
+    w->solved = 0;
+    w->stolen = 0;
+    w->q = (rfpos_strand_t**) la_malloc(sizeof(rfpos_strand_t*) * k);
+    pthread_mutex_init(&w->lock, NULL);
+    rfpos_init(&w->rfpos, d, n);
+  }
+
+  for (i = 0; i < threads; i++)
+  {
+    if (!self->w[i].q ||
+        pthread_create(&self->w[i].th, NULL, rfpos_pool_thread, self->w + i))
+    { // остановить уже запущенные потоки и освободить ресурсы
+      self->threads = i;
+      for (k = i; k < threads; k++)
+      {
+        rfpos_free(&self->w[k].rfpos);
+        pthread_mutex_destroy(&self->w[k].lock);
+        la_free(self->w[k].q);
+      }
+      rfpos_pool_free(self);
+      return -3; // ошибка: не удалось запустить поток
+    }
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// остановка рабочих потоков (после завершения всех заданий),
+// освобождение памяти
+void rfpos_pool_free(rfpos_pool_t *self)
+{
+  int i;
+
+  rfpos_pool_wait(self);
+
+  pthread_mutex_lock(&self->lock);
+  self->stop = 1;
+  pthread_cond_broadcast(&self->wake);
+  pthread_mutex_unlock(&self->lock);
+
+  for (i = 0; i < self->threads; i++)
+  {
+    rfpos_worker_t *w = self->w + i;
+    pthread_join(w->th, NULL);
+    rfpos_free(&w->rfpos);
+    pthread_mutex_destroy(&w->lock);
+    la_free(w->q);
+  }
+
+  for (i = 0; i < self->strands; i++)
+    pthread_mutex_destroy(&self->s[i].lock);
+
+  pthread_cond_destroy(&self->idle);
+  pthread_cond_destroy(&self->wake);
+  pthread_mutex_destroy(&self->lock);
+
+  la_free(self->w);
+  la_free(self->s);
+}
+//----------------------------------------------------------------------------
+// поставить задание в очередь (потокобезопасно, не блокируется на время
+// решения; может вызываться и из функции завершения)
+void rfpos_pool_submit(rfpos_pool_t *self, rfpos_job_t *job)
+{
+  rfpos_strand_t *s;
+  int idle;
+
+  s = self->s + (rfpos_hash(job->tag) & (self->strands - 1));
+  job->next = (rfpos_job_t*) 0;
+
+  RFPOS_POOL_ADD(&self->pending, 1);
+  if (job->tdl > 0. && !RFPOS_POOL_GET(&self->edf))
+    __atomic_store_n(&self->edf, 1, __ATOMIC_SEQ_CST);
+
+  // добавить задание в хвост очереди нити
+  pthread_mutex_lock(&s->lock);
+  if (s->tail)
+    s->tail->next = job;
+  else
+    s->head = job;
+  s->tail = job;
+  idle = !s->active;
+  s->active = 1;
+  if (idle)
+    s->tdl = job->tdl; // нить не в деке - срок можно менять
+  pthread_mutex_unlock(&s->lock);
+
+  // простаивающую нить поставить в деку одного из потоков (по кругу)
+  if (idle)
+  {
+    unsigned k = __atomic_fetch_add(&self->rr, 1, __ATOMIC_RELAXED);
+    rfpos_pool_push(self->w + k % (unsigned) self->threads, s);
+  }
+}
+//----------------------------------------------------------------------------
+// дождаться завершения всех поставленных в очередь заданий
+void rfpos_pool_wait(rfpos_pool_t *self)
+{
+  pthread_mutex_lock(&self->lock);
+  while (RFPOS_POOL_GET(&self->pending) > 0)
+    pthread_cond_wait(&self->idle, &self->lock);
+  pthread_mutex_unlock(&self->lock);
+}
+//----------------------------------------------------------------------------
+// установить опции решателя RFPOS_OPT_* всех рабочих потоков
+// (вызывается, когда в пуле нет незавершённых заданий)
+void rfpos_pool_opt(rfpos_pool_t *self, int opt)
+{
+  int i;
+  for (i = 0; i < self->threads; i++)
+    self->w[i].rfpos.opt = opt;
+}
+//----------------------------------------------------------------------------
+// сумма счётчиков решателей всех рабочих потоков
+void rfpos_pool_stat(rfpos_pool_t *self, rfpos_stat_t *s)
+{
+  rfpos_stat_t ws;
+  int i;
+
+  rfpos_stat_get(&self->w[0].rfpos, s);
+  for (i = 1; i < self->threads; i++)
+  {
+    rfpos_stat_get(&self->w[i].rfpos, &ws);
+    rfpos_stat_add(s, &ws);
+  }
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_pool.c" ***/
@@ -0,0 +1,145 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (многопоточный пул решателей с перехватом работы)
+ * Version: 0.1b
+ * File: "rfpos_pool.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_POOL_H
+#define RFPOS_POOL_H
+//----------------------------------------------------------------------------
+#include <pthread.h> // pthread_t, pthread_mutex_t, pthread_cond_t
+#include "rfpos.h"   // rfpos_t
+//----------------------------------------------------------------------------
+// максимальное число рабочих потоков
+#define RFPOS_POOL_MAX 256
+//----------------------------------------------------------------------------
+// задание для пула (один импульс); память задания принадлежит вызывающему
+// и не должна изменяться до вызова функции завершения
+typedef struct rfpos_job_ rfpos_job_t;
+struct rfpos_job_ {
+  // на входе:
+  unsigned tag;      // метка источника (задания с одинаковой меткой решаются
+                     // и завершаются строго в порядке постановки в очередь)
+  int it;            // максимальное число итераций
+  double e;          // желаемая численная точность оценки координат [м]
+  int d;             // размерность координат (2 или 3)
+  int n;             // число приёмников, принявших сигнал (n > d)
+  const double *m;   // матрица координат приёмников [n][d] (idx = NULL)
+                     // или общая таблица координат [][d]
+  const int *idx;    // индексы приёмников в таблице `m` [n] или NULL
+  const double *t;   // временные метки приёма сигнала приёмниками [n]
+  const double *s;   // СКО временных меток [n] или NULL (без весов)
+  const double *p;   // предполагаемые координаты передатчика [d] или NULL
+  void *arg;         // произвольные данные вызывающего
+  rfpos_cov_t *cov;  // ковариация и DOP решения или NULL
+  double tdl;        // срок решения по часам rfpos_time() [с] или 0 - без
+                     // срока (см. `rfpos_t`, поле `tdl`)
+  // на выходе:
+  double t0;              // оценка времени излучения сигнала передатчиком
+  double r[RFPOS_D_MAX];  // радиус вектор передатчика [d]
+  int st;                 // код возврата (как у rfpos_calc())
+  // служебное:
+  rfpos_job_t *next; // следующее задание в очереди метки
+};
+//----------------------------------------------------------------------------
+// функция завершения задания (вызывается из рабочего потока; для заданий
+// с одинаковой меткой - последовательно в порядке постановки в очередь)
+typedef void (*rfpos_done_t)(rfpos_job_t *job);
+//----------------------------------------------------------------------------
+// очередь заданий с одинаковым хешем метки ("нить"); в каждый момент
+// нить либо простаивает, либо находится ровно в одной деке, либо
+// обрабатывается ровно одним потоком - так сохраняется порядок по меткам
+typedef struct {
+  pthread_mutex_t lock; // защита очереди
+  rfpos_job_t *head;    // первое задание очереди
+  rfpos_job_t *tail;    // последнее задание очереди
+  int active;           // 1 - нить в деке или обрабатывается
+  double tdl;           // срок первого задания при постановке нити в деку
+                        // (0 - без срока)
+} rfpos_strand_t;
+//----------------------------------------------------------------------------
+struct rfpos_pool_;
+//----------------------------------------------------------------------------
+// рабочий поток: собственное рабочее пространство `rfpos_t` и дека нитей
+// (владелец берёт с "низа", остальные потоки перехватывают с "верха";
+// если заданы сроки решения, из деки берётся нить с самым ранним сроком)
+typedef struct {
+  struct rfpos_pool_ *pool; // пул, которому принадлежит поток
+  int id;                   // номер потока 0...threads-1
+  pthread_t th;             // поток
+  rfpos_t rfpos;            // рабочее пространство решателя
+
+  pthread_mutex_t lock;   // защита деки
+  rfpos_strand_t **q;     // кольцевой буфер деки [strands]
+  int top;                // индекс "верха" деки
+  int cnt;                // число нитей в деке
+
+  long solved; // число решённых заданий (статистика)
+  long stolen; // число перехваченных нитей (статистика)
+} rfpos_worker_t;
+//----------------------------------------------------------------------------
+// пул решателей
+typedef struct rfpos_pool_ {
+  int threads;         // число рабочих потоков
+  int strands;         // число нитей (степень двойки)
+  rfpos_done_t done;   // функция завершения задания или NULL
+  rfpos_worker_t *w;   // рабочие потоки [threads]
+  rfpos_strand_t *s;   // нити [strands]
+
+  pthread_mutex_t lock; // защита ожидания (wake, idle)
+  pthread_cond_t wake;  // появилась работа или требуется остановка
+  pthread_cond_t idle;  // все задания завершены
+  int sleepers;         // число спящих потоков
+  int queued;           // число нитей во всех деках
+  int pending;          // число незавершённых заданий
+  int stop;             // признак остановки
+  unsigned rr;          // счётчик для распределения нитей по декам
+  int edf;              // 1 - поставлено задание со сроком решения
+                        // (нити берутся из дек по сроку - EDF)
+} rfpos_pool_t;
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// инициализация пула, запуск рабочих потоков
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_pool_init(
+  rfpos_pool_t *self, // структура данных пула
+  int threads,        // число рабочих потоков (1...RFPOS_POOL_MAX)
+  int strands,        // число нитей (округляется вверх до степени двойки,
+                      // 0 - выбрать автоматически)
+  int d,              // максимальная размерность координат (2 или 3)
+  int n,              // максимальное число приёмников
+  rfpos_done_t done); // функция завершения задания или NULL
+//----------------------------------------------------------------------------
+// остановка рабочих потоков (после завершения всех заданий),
+// освобождение памяти
+void rfpos_pool_free(rfpos_pool_t *self);
+//----------------------------------------------------------------------------
+// поставить задание в очередь (потокобезопасно, не блокируется на время
+// решения; может вызываться и из функции завершения)
+void rfpos_pool_submit(rfpos_pool_t *self, rfpos_job_t *job);
+//----------------------------------------------------------------------------
+// дождаться завершения всех поставленных в очередь заданий
+void rfpos_pool_wait(rfpos_pool_t *self);
+//----------------------------------------------------------------------------
+// установить опции решателя RFPOS_OPT_* всех рабочих потоков
+// (вызывается, когда в пуле нет незавершённых заданий)
+void rfpos_pool_opt(rfpos_pool_t *self, int opt);
+//----------------------------------------------------------------------------
+// сумма счётчиков решателей всех рабочих потоков (можно вызывать во время
+// работы пула, без блокировок; без RFPOS_STATS - нули)
+void rfpos_pool_stat(rfpos_pool_t *self, rfpos_stat_t *s);
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_POOL_H
+
+/*** end of "rfpos_pool.h" ***/
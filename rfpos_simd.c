@@ -0,0 +1,585 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (векторные ядра совмещенного прохода по приёмникам)
+ * Version: 0.1b
+ * File: "rfpos_simd.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include <stdlib.h> // getenv(), atoi()
+#include <math.h>   // sqrt()
+#include "rfpos.h"  // RFPOS_U_MAX
+#include "rfpos_simd.h"
+//----------------------------------------------------------------------------
+// векторные ядра собираются для x86/x86_64 компилятором GCC/Clang
+// (опция RFPOS_NO_SIMD оставляет только скалярный вариант)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(LA_LONG_DOUBLE) && !defined(RFPOS_NO_SIMD)
+#  define RFPOS_SIMD_X86
+#endif
+//----------------------------------------------------------------------------
+#ifdef RFPOS_SIMD_X86
+#include <immintrin.h> // _mm*_sqrt_p*()
+#ifdef LA_FLOAT
+#  define RFPOS_SQRT_128(v) ((__typeof__(v)) _mm_sqrt_ps((__m128) (v)))
+#  define RFPOS_SQRT_256(v) ((__typeof__(v)) _mm256_sqrt_ps((__m256) (v)))
+#  define RFPOS_SQRT_512(v) ((__typeof__(v)) _mm512_sqrt_ps((__m512) (v)))
+#else
+#  define RFPOS_SQRT_128(v) ((__typeof__(v)) _mm_sqrt_pd((__m128d) (v)))
+#  define RFPOS_SQRT_256(v) ((__typeof__(v)) _mm256_sqrt_pd((__m256d) (v)))
+#  define RFPOS_SQRT_512(v) ((__typeof__(v)) _mm512_sqrt_pd((__m512d) (v)))
+#endif // LA_FLOAT
+#endif // RFPOS_SIMD_X86
+//----------------------------------------------------------------------------
+// скалярное ядро (подставляется с константными d, wt и kc)
+#if __GNUC__
+__attribute__((always_inline))
+#endif
+static inline double rfpos_fw_d(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к невязке добавляются постоянные слагаемые
+  const double *x,      // точка (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  const la_float_t *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const la_float_t *cf, // постоянные слагаемые невязки [n] (при kc = 1)
+  double *a,            // нижний треугольник W^(T) * W построчно
+  double *b)            // вектор W^(T) * F [d+1]
+{
+  int i, j, k, l, u = d + 1;
+  double fm = 0., q, f, c, w[RFPOS_U_MAX];
+
+  for (l = 0; l < u * (u + 1) / 2; l++)
+    a[l] = 0.;
+  for (j = 0; j < u; j++)
+    b[j] = 0.;
+
+  for (i = 0; i < n; i++)
+  {
+    // невязка и строка матрицы Якоби
+    f = 0.;
+    for (j = 0; j < d; j++)
+    {
+      q = x[j] - y[j][i];
+      w[j] = 2. * q;
+      f += q * q;
+    }
+    q = x[d] - y[d][i];
+    w[d] = -2. * q;
+    f -= q * q;
+    if (kc) f += cf[i];
+
+    // вес приёмника
+    c = 1.;
+    if (wt)
+    {
+      q *= q;
+      if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      c = sw[i] / q;
+    }
+
+    fm += c * f * f;
+
+    // накопление W^(T) * C * W и W^(T) * C * F
+    for (j = 0, l = 0; j < u; j++)
+    {
+      q = wt ? c * w[j] : w[j];
+      for (k = 0; k <= j; k++, l++)
+        a[l] += q * w[k];
+      b[j] += q * f;
+    }
+  }
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// скалярное ядро для d=2
+static double rfpos_fw_2(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_fw_d(n, 2, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_fw_d(n, 2, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_fw_d(n, 2, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_fw_d(n, 2, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро для d=3
+static double rfpos_fw_3(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_fw_d(n, 3, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_fw_d(n, 3, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_fw_d(n, 3, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_fw_d(n, 3, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро одинарной точности (подставляется с константными d, wt
+// и kc): данные читаются в float, вычисления и суммы - в double
+#if __GNUC__
+__attribute__((always_inline))
+#endif
+static inline double rfpos_fwf_d(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к невязке добавляются постоянные слагаемые
+  const double *x,      // точка (x0, y0, z0, d0) [d+1]
+  float *const *y,      // столбцы входных данных [d+1][n]
+  const float *sw,      // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const float *cf,      // постоянные слагаемые невязки [n] (при kc = 1)
+  double *a,            // нижний треугольник W^(T) * W построчно
+  double *b)            // вектор W^(T) * F [d+1]
+{
+  int i, j, k, l, u = d + 1;
+  double fm = 0., q, f, c, w[RFPOS_U_MAX];
+
+  for (l = 0; l < u * (u + 1) / 2; l++)
+    a[l] = 0.;
+  for (j = 0; j < u; j++)
+    b[j] = 0.;
+
+  for (i = 0; i < n; i++)
+  {
+    f = 0.;
+    for (j = 0; j < d; j++)
+    {
+      q = x[j] - y[j][i];
+      w[j] = 2. * q;
+      f += q * q;
+    }
+    q = x[d] - y[d][i];
+    w[d] = -2. * q;
+    f -= q * q;
+    if (kc) f += cf[i];
+
+    c = 1.;
+    if (wt)
+    {
+      q *= q;
+      if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      c = sw[i] / q;
+    }
+
+    fm += c * f * f;
+    for (j = 0, l = 0; j < u; j++)
+    {
+      q = wt ? c * w[j] : w[j];
+      for (k = 0; k <= j; k++, l++)
+        a[l] += q * w[k];
+      b[j] += q * f;
+    }
+  }
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// скалярное ядро одинарной точности для d=2
+static double rfpos_fwf_2(
+  int n, const double *x, float *const *y, const float *sw,
+  const float *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_fwf_d(n, 2, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_fwf_d(n, 2, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_fwf_d(n, 2, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_fwf_d(n, 2, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро одинарной точности для d=3
+static double rfpos_fwf_3(
+  int n, const double *x, float *const *y, const float *sw,
+  const float *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_fwf_d(n, 3, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_fwf_d(n, 3, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_fwf_d(n, 3, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_fwf_d(n, 3, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро разностного (TDOA) прохода (подставляется с константными
+// d, wt и kc)
+#if __GNUC__
+__attribute__((always_inline))
+#endif
+static inline double rfpos_td_d(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к квадрату дальности добавляются cf[i]
+  const double *x,      // точка (x0, y0, z0) [d]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  const la_float_t *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const la_float_t *cf, // постоянные слагаемые [n] (при kc = 1)
+  double *a,            // нижний треугольник построчно
+  double *b)            // вектор [d+1]
+{
+  int i, j, k, l, u = d + 1;
+  double fm = 0., q, f, c, w[RFPOS_U_MAX];
+
+  for (l = 0; l < u * (u + 1) / 2; l++)
+    a[l] = 0.;
+  for (j = 0; j < u; j++)
+    b[j] = 0.;
+
+  for (i = 0; i < n; i++)
+  {
+    // дальность, единичный вектор u и невязка e = |X - S| - d
+    f = 0.;
+    for (j = 0; j < d; j++)
+    {
+      w[j] = x[j] - y[j][i];
+      f += w[j] * w[j];
+    }
+    if (kc) f += cf[i];
+    f = sqrt(f);
+    q = 1. / (f < RFPOS_W_QMIN ? RFPOS_W_QMIN : f);
+    for (j = 0; j < d; j++)
+      w[j] *= q;
+    w[d] = 1.;
+    f -= y[d][i];
+
+    c = wt ? sw[i] : 1.;
+    fm += c * f * f;
+
+    for (j = 0, l = 0; j < u; j++)
+    {
+      q = wt ? c * w[j] : w[j];
+      for (k = 0; k <= j; k++, l++)
+        a[l] += q * w[k];
+      b[j] += q * f;
+    }
+  }
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// скалярное ядро разностного прохода для d=2
+static double rfpos_td_2(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_td_d(n, 2, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_td_d(n, 2, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_td_d(n, 2, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_td_d(n, 2, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро разностного прохода для d=3
+static double rfpos_td_3(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *a, double *b)
+{
+  if (cf)
+    return sw ? rfpos_td_d(n, 3, 1, 1, x, y, sw, cf, a, b) :
+                rfpos_td_d(n, 3, 0, 1, x, y, sw, cf, a, b);
+  return sw ? rfpos_td_d(n, 3, 1, 0, x, y, sw, cf, a, b) :
+              rfpos_td_d(n, 3, 0, 0, x, y, sw, cf, a, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро прохода без нормальной матрицы (подставляется с
+// константными d, wt и kc)
+#if __GNUC__
+__attribute__((always_inline))
+#endif
+static inline double rfpos_gr_d(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  int wt,               // 1 - взвешенный МНК
+  int kc,               // 1 - к невязке добавляются постоянные слагаемые
+  const double *x,      // точка (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  const la_float_t *sw, // веса 1/(2*C*sigma)^2 [n] (при wt = 1)
+  const la_float_t *cf, // постоянные слагаемые невязки [n] (при kc = 1)
+  double *b)            // вектор W^(T) * F [d+1]
+{
+  int i, j, u = d + 1;
+  double fm = 0., q, f, c, w[RFPOS_U_MAX];
+
+  for (j = 0; j < u; j++)
+    b[j] = 0.;
+
+  for (i = 0; i < n; i++)
+  {
+    f = 0.;
+    for (j = 0; j < d; j++)
+    {
+      q = x[j] - y[j][i];
+      w[j] = 2. * q;
+      f += q * q;
+    }
+    q = x[d] - y[d][i];
+    w[d] = -2. * q;
+    f -= q * q;
+    if (kc) f += cf[i];
+
+    c = 1.;
+    if (wt)
+    {
+      q *= q;
+      if (q < RFPOS_W_QMIN * RFPOS_W_QMIN)
+        q = RFPOS_W_QMIN * RFPOS_W_QMIN;
+      c = sw[i] / q;
+    }
+
+    fm += c * f * f;
+    q = wt ? c * f : f;
+    for (j = 0; j < u; j++)
+      b[j] += w[j] * q;
+  }
+
+  return fm;
+}
+//----------------------------------------------------------------------------
+// скалярное ядро прохода без нормальной матрицы для d=2
+static double rfpos_gr_2(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *b)
+{
+  if (cf)
+    return sw ? rfpos_gr_d(n, 2, 1, 1, x, y, sw, cf, b) :
+                rfpos_gr_d(n, 2, 0, 1, x, y, sw, cf, b);
+  return sw ? rfpos_gr_d(n, 2, 1, 0, x, y, sw, cf, b) :
+              rfpos_gr_d(n, 2, 0, 0, x, y, sw, cf, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро прохода без нормальной матрицы для d=3
+static double rfpos_gr_3(
+  int n, const double *x, la_float_t *const *y, const la_float_t *sw,
+  const la_float_t *cf, double *b)
+{
+  if (cf)
+    return sw ? rfpos_gr_d(n, 3, 1, 1, x, y, sw, cf, b) :
+                rfpos_gr_d(n, 3, 0, 1, x, y, sw, cf, b);
+  return sw ? rfpos_gr_d(n, 3, 1, 0, x, y, sw, cf, b) :
+              rfpos_gr_d(n, 3, 0, 0, x, y, sw, cf, b);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро оценки гипотезы (подставляется с константным d)
+#if __GNUC__
+__attribute__((always_inline))
+#endif
+static inline double rfpos_sc_d(
+  int n,                // число приёмников
+  int d,                // размерность задачи (2 или 3)
+  const double *x,      // гипотеза (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y, // столбцы входных данных [d+1][n]
+  double thr,           // порог невязки "своих" приёмников [м]
+  int *cnt)             // число "своих" приёмников
+{
+  int i, j;
+  double cs = 0., q, f, t2 = thr * thr;
+
+  *cnt = 0;
+  for (i = 0; i < n; i++)
+  {
+    f = 0.;
+    for (j = 0; j < d; j++)
+    {
+      q = x[j] - y[j][i];
+      f += q * q;
+    }
+    q = sqrt(f) + x[d] - y[d][i];
+    q *= q;
+    if (q <= t2)
+    {
+      cs += q;
+      (*cnt)++;
+    }
+    else
+      cs += t2;
+  }
+
+  return cs;
+}
+//----------------------------------------------------------------------------
+// скалярное ядро оценки гипотезы для d=2
+static double rfpos_sc_2(
+  int n, const double *x, la_float_t *const *y, double thr, int *cnt)
+{
+  return rfpos_sc_d(n, 2, x, y, thr, cnt);
+}
+//----------------------------------------------------------------------------
+// скалярное ядро оценки гипотезы для d=3
+static double rfpos_sc_3(
+  int n, const double *x, la_float_t *const *y, double thr, int *cnt)
+{
+  return rfpos_sc_d(n, 3, x, y, thr, cnt);
+}
+//----------------------------------------------------------------------------
+#ifdef RFPOS_SIMD_X86
+// SSE2 (2 x double)
+#define RFPOS_KERN(x) rfpos_fw_sse2##x
+#define RFPOS_KERN_ATTR __attribute__((target("sse2")))
+#define RFPOS_KERN_SIZE 16
+#define RFPOS_KERN_SQRT(v) RFPOS_SQRT_128(v)
+#include "rfpos_kern.h"
+
+// AVX2 + FMA (4 x double)
+#define RFPOS_KERN(x) rfpos_fw_avx2##x
+#define RFPOS_KERN_ATTR __attribute__((target("avx2,fma")))
+#define RFPOS_KERN_SIZE 32
+#define RFPOS_KERN_SQRT(v) RFPOS_SQRT_256(v)
+#include "rfpos_kern.h"
+
+// AVX-512F (8 x double)
+#define RFPOS_KERN(x) rfpos_fw_avx512##x
+#define RFPOS_KERN_ATTR __attribute__((target("avx512f,fma")))
+#define RFPOS_KERN_SIZE 64
+#define RFPOS_KERN_SQRT(v) RFPOS_SQRT_512(v)
+#include "rfpos_kern.h"
+
+// ядра одинарной точности (RFPOS_OPT_F32): 4, 8 и 16 x float
+#define RFPOS_KERN(x) rfpos_fwf_sse2##x
+#define RFPOS_KERN_ATTR __attribute__((target("sse2")))
+#define RFPOS_KERN_SIZE 16
+#define RFPOS_KERN_T float
+#define RFPOS_KERN_F32
+#include "rfpos_kern.h"
+
+#define RFPOS_KERN(x) rfpos_fwf_avx2##x
+#define RFPOS_KERN_ATTR __attribute__((target("avx2,fma")))
+#define RFPOS_KERN_SIZE 32
+#define RFPOS_KERN_T float
+#define RFPOS_KERN_F32
+#include "rfpos_kern.h"
+
+#define RFPOS_KERN(x) rfpos_fwf_avx512##x
+#define RFPOS_KERN_ATTR __attribute__((target("avx512f,fma")))
+#define RFPOS_KERN_SIZE 64
+#define RFPOS_KERN_T float
+#define RFPOS_KERN_F32
+#include "rfpos_kern.h"
+#endif // RFPOS_SIMD_X86
+//----------------------------------------------------------------------------
+// определить лучший набор инструкций, поддерживаемый процессором
+int rfpos_simd_detect(void)
+{
+  int simd = RFPOS_SIMD_NONE;
+  const char *env = getenv("RFPOS_SIMD");
+
+#ifdef RFPOS_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2"))
+    simd = RFPOS_SIMD_SSE2;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    simd = RFPOS_SIMD_AVX2;
+  if (__builtin_cpu_supports("avx512f"))
+    simd = RFPOS_SIMD_AVX512;
+#endif // RFPOS_SIMD_X86
+
+  if (env && atoi(env) < simd)
+    simd = atoi(env) < 0 ? RFPOS_SIMD_NONE : atoi(env);
+
+  return simd;
+}
+//----------------------------------------------------------------------------
+// вернуть ядро для заданного набора инструкций и размерности d (2 или 3)
+rfpos_fw_t rfpos_simd_fw(int simd, int d)
+{
+#ifdef RFPOS_SIMD_X86
+  switch (simd)
+  {
+    case RFPOS_SIMD_AVX512:
+      return d == 3 ? rfpos_fw_avx512_3 : rfpos_fw_avx512_2;
+    case RFPOS_SIMD_AVX2:
+      return d == 3 ? rfpos_fw_avx2_3 : rfpos_fw_avx2_2;
+    case RFPOS_SIMD_SSE2:
+      return d == 3 ? rfpos_fw_sse2_3 : rfpos_fw_sse2_2;
+  }
+#endif // RFPOS_SIMD_X86
+  return d == 3 ? rfpos_fw_3 : rfpos_fw_2;
+}
+//----------------------------------------------------------------------------
+// вернуть ядро одинарной точности для заданного набора инструкций и d
+rfpos_fwf_t rfpos_simd_fwf(int simd, int d)
+{
+#ifdef RFPOS_SIMD_X86
+  switch (simd)
+  {
+    case RFPOS_SIMD_AVX512:
+      return d == 3 ? rfpos_fwf_avx512_3 : rfpos_fwf_avx512_2;
+    case RFPOS_SIMD_AVX2:
+      return d == 3 ? rfpos_fwf_avx2_3 : rfpos_fwf_avx2_2;
+    case RFPOS_SIMD_SSE2:
+      return d == 3 ? rfpos_fwf_sse2_3 : rfpos_fwf_sse2_2;
+  }
+#endif // RFPOS_SIMD_X86
+  return d == 3 ? rfpos_fwf_3 : rfpos_fwf_2;
+}
+//----------------------------------------------------------------------------
+// вернуть ядро разностного прохода для заданного набора инструкций и d
+rfpos_td_t rfpos_simd_td(int simd, int d)
+{
+#ifdef RFPOS_SIMD_X86
+  switch (simd)
+  {
+    case RFPOS_SIMD_AVX512:
+      return d == 3 ? rfpos_fw_avx512_td3 : rfpos_fw_avx512_td2;
+    case RFPOS_SIMD_AVX2:
+      return d == 3 ? rfpos_fw_avx2_td3 : rfpos_fw_avx2_td2;
+    case RFPOS_SIMD_SSE2:
+      return d == 3 ? rfpos_fw_sse2_td3 : rfpos_fw_sse2_td2;
+  }
+#endif // RFPOS_SIMD_X86
+  return d == 3 ? rfpos_td_3 : rfpos_td_2;
+}
+//----------------------------------------------------------------------------
+// вернуть ядро прохода без нормальной матрицы для набора инструкций и d
+rfpos_gr_t rfpos_simd_gr(int simd, int d)
+{
+#ifdef RFPOS_SIMD_X86
+  switch (simd)
+  {
+    case RFPOS_SIMD_AVX512:
+      return d == 3 ? rfpos_fw_avx512_gr3 : rfpos_fw_avx512_gr2;
+    case RFPOS_SIMD_AVX2:
+      return d == 3 ? rfpos_fw_avx2_gr3 : rfpos_fw_avx2_gr2;
+    case RFPOS_SIMD_SSE2:
+      return d == 3 ? rfpos_fw_sse2_gr3 : rfpos_fw_sse2_gr2;
+  }
+#endif // RFPOS_SIMD_X86
+  return d == 3 ? rfpos_gr_3 : rfpos_gr_2;
+}
+//----------------------------------------------------------------------------
+// вернуть ядро оценки гипотезы для заданного набора инструкций и d
+rfpos_sc_t rfpos_simd_sc(int simd, int d)
+{
+#ifdef RFPOS_SIMD_X86
+  switch (simd)
+  {
+    case RFPOS_SIMD_AVX512:
+      return d == 3 ? rfpos_fw_avx512_sc3 : rfpos_fw_avx512_sc2;
+    case RFPOS_SIMD_AVX2:
+      return d == 3 ? rfpos_fw_avx2_sc3 : rfpos_fw_avx2_sc2;
+    case RFPOS_SIMD_SSE2:
+      return d == 3 ? rfpos_fw_sse2_sc3 : rfpos_fw_sse2_sc2;
+  }
+#endif // RFPOS_SIMD_X86
+  return d == 3 ? rfpos_sc_3 : rfpos_sc_2;
+}
+//----------------------------------------------------------------------------
+// вернуть название набора инструкций
+const char *rfpos_simd_name(int simd)
+{
+  switch (simd)
+  {
+    case RFPOS_SIMD_SSE2:   return "sse2";
+    case RFPOS_SIMD_AVX2:   return "avx2";
+    case RFPOS_SIMD_AVX512: return "avx512";
+  }
+  return "none";
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_simd.c" ***/
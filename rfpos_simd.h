@@ -0,0 +1,132 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (векторные ядра совмещенного прохода по приёмникам)
+ * Version: 0.1b
+ * File: "rfpos_simd.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_SIMD_H
+#define RFPOS_SIMD_H
+//----------------------------------------------------------------------------
+#include "la.h" // `la_float_t`
+//----------------------------------------------------------------------------
+// минимальная дальность [м] при вычислении весов взвешенного МНК
+// (ограничивает вес приёмника, оказавшегося рядом с текущей точкой)
+#define RFPOS_W_QMIN 1.
+//----------------------------------------------------------------------------
+// наборы инструкций (в порядке возрастания)
+#define RFPOS_SIMD_NONE   0 // скалярный вариант
+#define RFPOS_SIMD_SSE2   1 // 128 бит
+#define RFPOS_SIMD_AVX2   2 // 256 бит
+#define RFPOS_SIMD_AVX512 3 // 512 бит
+//----------------------------------------------------------------------------
+// тип ядра совмещенного прохода по приёмникам: за одно чтение столбцов
+// входных данных вычисляются невязка F(X,Y), строки матрицы Якоби W(X,Y),
+// нижний треугольник нормальной матрицы W^(T) * W (построчно: a00, a10,
+// a11, a20, ...) и вектор W^(T) * F (возвращается |F|^2)
+// если задан вектор sw, каждый приёмник входит с весом
+// c[i] = sw[i] / max(q[i]^2, RFPOS_W_QMIN^2), где q[i] = d0 - d[i] - текущая
+// оценка дальности (дисперсия F[i] примерно равна 4 * q[i]^2 * (C*sigma)^2),
+// т.е. вычисляются W^(T) * C * W, W^(T) * C * F и F^(T) * C * F
+// если задан вектор cf, к каждой невязке F[i] добавляется постоянное
+// слагаемое cf[i] (квадрат расстояния по известной координате передатчика)
+typedef double (*rfpos_fw_t)(
+  int n,                   // число приёмников
+  const double *x,         // точка (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y,    // столбцы входных данных [d+1][n]
+  const la_float_t *sw,    // веса 1/(2*C*sigma)^2 [n] или NULL
+  const la_float_t *cf,    // постоянные слагаемые невязки [n] или NULL
+  double *a,               // нижний треугольник W^(T) * W [(d+1)*(d+2)/2]
+  double *b);              // вектор W^(T) * F [d+1]
+//----------------------------------------------------------------------------
+// тип ядра совмещенного прохода по входным данным одинарной точности
+// (режим RFPOS_OPT_F32): то же, что `rfpos_fw_t`, но столбцы, веса и
+// постоянные слагаемые заданы в float (координаты - относительно начала
+// координат площадки), поэтому за одну команду обрабатывается вдвое больше
+// приёмников; результат (суммы) возвращается в double
+typedef double (*rfpos_fwf_t)(
+  int n,                   // число приёмников
+  const double *x,         // точка (x0, y0, z0, d0) [d+1]
+  float *const *y,         // столбцы входных данных [d+1][n]
+  const float *sw,         // веса 1/(2*C*sigma)^2 [n] или NULL
+  const float *cf,         // постоянные слагаемые невязки [n] или NULL
+  double *a,               // нижний треугольник W^(T) * W [(d+1)*(d+2)/2]
+  double *b);              // вектор W^(T) * F [d+1]
+//----------------------------------------------------------------------------
+// тип ядра разностного (TDOA) прохода (режим RFPOS_OPT_TDOA): невязки по
+// дальности e[i] = |X - S[i]| - d[i] (под корнем добавляется cf[i], если
+// задан), строки (u[i], 1), где u[i] = (X - S[i]) / |X - S[i]| - единичный
+// вектор от приёмника; накапливаются нижний треугольник суммы
+// c[i] * (u[i], 1) * (u[i], 1)^(T), вектор sum(c[i] * (u[i], 1) * e[i]) и
+// возвращается sum(c[i] * e[i]^2), где c[i] = sw[i] (или 1 без весов);
+// последняя строка содержит sum(c * u), sum(c) и sum(c * e), по которым
+// вызывающая сторона исключает d0 (x[d] не используется)
+typedef double (*rfpos_td_t)(
+  int n,                   // число приёмников
+  const double *x,         // точка (x0, y0, z0) [d]
+  la_float_t *const *y,    // столбцы входных данных [d+1][n]
+  const la_float_t *sw,    // веса 1/(2*C*sigma)^2 [n] или NULL
+  const la_float_t *cf,    // постоянные слагаемые квадрата дальности [n]
+                           // или NULL
+  double *a,               // нижний треугольник [(d+1)*(d+2)/2]
+  double *b);              // вектор [d+1]
+//----------------------------------------------------------------------------
+// тип ядра прохода без нормальной матрицы (режим RFPOS_OPT_CHORD): то же,
+// что `rfpos_fw_t`, но накапливается только вектор W^(T) * C * F
+// (O(n * d) операций вместо O(n * d^2)), возвращается F^(T) * C * F
+typedef double (*rfpos_gr_t)(
+  int n,                   // число приёмников
+  const double *x,         // точка (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y,    // столбцы входных данных [d+1][n]
+  const la_float_t *sw,    // веса 1/(2*C*sigma)^2 [n] или NULL
+  const la_float_t *cf,    // постоянные слагаемые невязки [n] или NULL
+  double *b);              // вектор W^(T) * F [d+1]
+//----------------------------------------------------------------------------
+// тип ядра оценки гипотезы (RANSAC): для точки x вычисляются невязки по
+// дальности r[i] = |X - S[i]| + d0 - d[i] всех приёмников, возвращается
+// сумма min(r[i]^2, thr^2) (чем меньше, тем лучше гипотеза), в cnt
+// записывается число "своих" приёмников (|r[i]| <= thr)
+typedef double (*rfpos_sc_t)(
+  int n,                   // число приёмников
+  const double *x,         // гипотеза (x0, y0, z0, d0) [d+1]
+  la_float_t *const *y,    // столбцы входных данных [d+1][n]
+  double thr,              // порог невязки "своих" приёмников [м]
+  int *cnt);               // число "своих" приёмников
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// определить лучший набор инструкций, поддерживаемый процессором
+// (переменная окружения RFPOS_SIMD=0...3 ограничивает выбор сверху)
+int rfpos_simd_detect(void);
+//----------------------------------------------------------------------------
+// вернуть ядро для заданного набора инструкций и размерности d (2 или 3)
+// (если набор не поддерживается сборкой, возвращается ближайшее младшее)
+rfpos_fw_t rfpos_simd_fw(int simd, int d);
+//----------------------------------------------------------------------------
+// вернуть ядро одинарной точности для заданного набора инструкций и d
+rfpos_fwf_t rfpos_simd_fwf(int simd, int d);
+//----------------------------------------------------------------------------
+// вернуть ядро разностного прохода для заданного набора инструкций и d
+rfpos_td_t rfpos_simd_td(int simd, int d);
+//----------------------------------------------------------------------------
+// вернуть ядро прохода без нормальной матрицы для набора инструкций и d
+rfpos_gr_t rfpos_simd_gr(int simd, int d);
+//----------------------------------------------------------------------------
+// вернуть ядро оценки гипотезы для заданного набора инструкций и d
+rfpos_sc_t rfpos_simd_sc(int simd, int d);
+//----------------------------------------------------------------------------
+// вернуть название набора инструкций
+const char *rfpos_simd_name(int simd);
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_SIMD_H
+
+/*** end of "rfpos_simd.h" ***/
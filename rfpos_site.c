@@ -0,0 +1,133 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (кэш данных подмножеств неподвижных приёмников по битовой маске)
+ * Version: 0.1b
+ * File: "rfpos_site.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include "rfpos_site.h"
+//----------------------------------------------------------------------------
+// хеш маски: 64 разряда свёртываются в 32 для общего хеша rfpos_hash()
+static unsigned rfpos_site_hash(uint64_t mask)
+{
+  return rfpos_hash((unsigned) mask ^ (unsigned) (mask >> 32));
+}
+//----------------------------------------------------------------------------
+// сравнение маски ячейки с искомой (для rfpos_lru_find())
+static int rfpos_site_eq(const void *e, const void *key)
+{
+  return ((const rfpos_site_entry_t*) e)->mask == *(const uint64_t*) key;
+}
+//----------------------------------------------------------------------------
+// инициализация кэша, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_site_init(
+  rfpos_site_t *self, // структура данных кэша
+  int d,              // размерность координат (2 или 3)
+  int n,              // число приёмников в таблице
+  const double *m,    // таблица координат приёмников [n][d]
+  int max)            // максимальное число подмножеств
+{
+  if (n < 1 || d < 2 || d > RFPOS_D_MAX)
+    return -1; // ошибка: недопустимые параметры
+
+  self->d     = d;
+  self->n     = n;
+  self->m     = m;
+  self->hit   = 0;
+  self->miss  = 0;
+  self->evict = 0;
+
+  return rfpos_lru_init(&self->lru, max, sizeof(rfpos_site_entry_t));
+}
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_site_free(rfpos_site_t *self)
+{
+  rfpos_lru_free(&self->lru);
+}
+//----------------------------------------------------------------------------
+// найти данные подмножества по маске приёмников (при отсутствии - вычислить
+// и запомнить, вытеснив давно не использованное подмножество)
+const rfpos_sub_t *rfpos_site_sub(rfpos_site_t *self, uint64_t mask)
+{
+  int i, n = 0;
+  unsigned h = rfpos_site_hash(mask);
+  uint64_t b;
+  rfpos_site_entry_t *e;
+
+  i = rfpos_lru_find(&self->lru, h, rfpos_site_eq, &mask);
+  if (i >= 0)
+  {
+    self->hit++;
+    return &((rfpos_site_entry_t*) RFPOS_LRU_NODE(&self->lru, i))->sub;
+  }
+
+  // приёмники подмножества по возрастанию номера
+  for (b = mask; b; b &= b - 1)
+    self->idx[n++] = __builtin_ctzll(b);
+  if (n <= self->d)
+    return (const rfpos_sub_t*) 0;
+
+  // новое подмножество: освободить место, вытеснив давно не использованное
+  self->miss++;
+  i = rfpos_lru_add(&self->lru, h, &self->evict);
+  e = (rfpos_site_entry_t*) RFPOS_LRU_NODE(&self->lru, i);
+  e->mask = mask;
+  rfpos_sub_init(&e->sub, self->d, n, self->m, self->idx);
+
+  return &e->sub;
+}
+//----------------------------------------------------------------------------
+// rfpos_calc_w() для импульса, принятого приёмниками таблицы
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_site(
+  rfpos_t *self,      // структура данных компонента
+  rfpos_site_t *site, // приёмники и кэш подмножеств
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const int *idx,  // индексы приёмников в таблице [n]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] или NULL
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  int i, k, lim = site->n < RFPOS_SITE_MAX ? site->n : RFPOS_SITE_MAX;
+  uint64_t mask = 0, b;
+  const rfpos_sub_t *sub;
+
+  // маска приёмников (повторные и дальние приёмники - без кэша)
+  for (i = 0; i < n; i++)
+  {
+    k = idx[i];
+    if (k < 0 || k >= lim || (mask >> k & 1))
+      return rfpos_calc_sub(self, (const rfpos_sub_t*) 0, it, e, site->d, n,
+                            site->m, idx, t, s, p, t0, r);
+    mask |= (uint64_t) 1 << k;
+    site->pos[k] = i;
+  }
+
+  sub = rfpos_site_sub(site, mask);
+
+  // переупорядочить импульс по возрастанию номера приёмника
+  for (b = mask, i = 0; b; b &= b - 1, i++)
+  {
+    k = __builtin_ctzll(b);
+    site->idx[i] = k;
+    site->t[i]   = t[site->pos[k]];
+    if (s) site->s[i] = s[site->pos[k]];
+  }
+
+  return rfpos_calc_sub(self, sub, it, e, site->d, n, site->m, site->idx,
+                        site->t, s ? site->s : (const double*) 0, p, t0, r);
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_site.c" ***/
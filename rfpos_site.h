@@ -0,0 +1,99 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (кэш данных подмножеств неподвижных приёмников по битовой маске)
+ * Version: 0.1b
+ * File: "rfpos_site.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_SITE_H
+#define RFPOS_SITE_H
+//----------------------------------------------------------------------------
+#include <stdint.h> // uint64_t
+#include "rfpos.h"  // `rfpos_t`, `rfpos_sub_t`
+#include "rfpos_lru.h" // `rfpos_lru_t`
+//----------------------------------------------------------------------------
+// число приёмников, подмножества которых кэшируются (разрядность маски);
+// импульсы с приёмниками за этой границей решаются без кэша
+#define RFPOS_SITE_MAX 64
+//----------------------------------------------------------------------------
+// данные одного подмножества приёмников
+typedef struct {
+  rfpos_lru_node_t node; // служебная часть ячейки таблицы
+  uint64_t mask;   // битовая маска приёмников подмножества
+  rfpos_sub_t sub; // данные подмножества (приёмники по возрастанию номера)
+} rfpos_site_entry_t;
+//----------------------------------------------------------------------------
+// неподвижные приёмники и кэш данных их подмножеств: хеш-таблица
+// с открытой адресацией (линейное пробирование) и вытеснением давно
+// не использованных подмножеств (LRU); память фиксирована
+typedef struct {
+  int d;            // размерность координат (2 или 3)
+  int n;            // число приёмников в таблице
+  const double *m;  // таблица координат приёмников [n][d] (память
+                    // вызывающего, не изменяется, пока используется кэш)
+
+  rfpos_lru_t lru; // таблица ячеек `rfpos_site_entry_t` (lru.cnt - число
+                   // подмножеств)
+  long hit;   // число импульсов с найденным подмножеством (статистика)
+  long miss;  // число импульсов с новым подмножеством (статистика)
+  long evict; // число вытесненных подмножеств (статистика)
+
+  // импульс, переупорядоченный по возрастанию номера приёмника
+  int pos[RFPOS_SITE_MAX];    // позиция приёмника во входном импульсе
+  int idx[RFPOS_SITE_MAX];    // индексы приёмников
+  double t[RFPOS_SITE_MAX];   // временные метки [с]
+  double s[RFPOS_SITE_MAX];   // СКО временных меток [с]
+} rfpos_site_t;
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// инициализация кэша, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_site_init(
+  rfpos_site_t *self, // структура данных кэша
+  int d,              // размерность координат (2 или 3)
+  int n,              // число приёмников в таблице
+  const double *m,    // таблица координат приёмников [n][d]
+  int max);           // максимальное число подмножеств
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_site_free(rfpos_site_t *self);
+//----------------------------------------------------------------------------
+// найти данные подмножества по маске приёмников (при отсутствии - вычислить
+// и запомнить, вытеснив давно не использованное подмножество); найденное
+// подмножество становится последним в LRU
+// (возвращается NULL, если в маске не более d приёмников)
+const rfpos_sub_t *rfpos_site_sub(rfpos_site_t *self, uint64_t mask);
+//----------------------------------------------------------------------------
+// rfpos_calc_w() для импульса, принятого приёмниками таблицы: приёмники
+// упорядочиваются по возрастанию номера, данные их подмножества берутся
+// из кэша (см. rfpos_calc_sub()); при повторных или не входящих в первые
+// RFPOS_SITE_MAX приёмниках импульс решается без кэша
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_site(
+  rfpos_t *self,      // структура данных компонента
+  rfpos_site_t *site, // приёмники и кэш подмножеств
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const int *idx,  // индексы приёмников в таблице [n]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  const double *s, // СКО временных меток [n] или NULL
+  const double *p, // предполагаемые координаты передатчика [d] или NULL
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_SITE_H
+
+/*** end of "rfpos_site.h" ***/
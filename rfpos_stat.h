@@ -0,0 +1,140 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (счётчики и гистограммы решателя, история итераций последнего решения)
+ * Version: 0.1b
+ * File: "rfpos_stat.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_STAT_H
+#define RFPOS_STAT_H
+//----------------------------------------------------------------------------
+#include <time.h> // clock_gettime()
+//----------------------------------------------------------------------------
+// размеры гистограмм и истории
+#define RFPOS_STAT_RET  8  // коды возврата: [0] - успех, [k] - код -k
+#define RFPOS_STAT_IT   32 // число итераций 0...31 (последний - 31 и более)
+#define RFPOS_STAT_NS   24 // время решения [2^k, 2^(k+1)) нс (до 16 мс)
+#define RFPOS_STAT_HIST 32 // итераций в истории последнего решения
+//----------------------------------------------------------------------------
+// фазы итераций (время и число вызовов)
+#define RFPOS_STAT_FW  0 // невязка и матрица Якоби (совмещенный проход:
+                         // нормальные уравнения или W и F для QR)
+#define RFPOS_STAT_F   1 // только невязка (пробные шаги RFPOS_OPT_LM)
+#define RFPOS_STAT_LIN 2 // решение линейной системы (la_chol(), la_qr_solve())
+#define RFPOS_STAT_PH  3 // число фаз
+//----------------------------------------------------------------------------
+// счётчики решателя (одно рабочее пространство `rfpos_t` - один поток):
+// пишет только поток-владелец, читать можно из любого потока без
+// блокировок (rfpos_stat_get())
+typedef struct {
+  unsigned long long solves;  // число решений
+  unsigned long long iters;   // суммарное число итераций
+  unsigned long long ns;      // суммарное время решений [нс]
+  unsigned long long ret[RFPOS_STAT_RET];  // решения по кодам возврата
+  unsigned long long ph_ns[RFPOS_STAT_PH]; // время по фазам [нс]
+  unsigned long long ph_n[RFPOS_STAT_PH];  // число вызовов по фазам
+  unsigned long long h_it[RFPOS_STAT_IT];  // гистограмма числа итераций
+  unsigned long long h_ns[RFPOS_STAT_NS];  // гистограмма времени решения
+} rfpos_stat_t;
+//----------------------------------------------------------------------------
+// история итераций последнего решения
+typedef struct {
+  int n;    // число записанных итераций (не более RFPOS_STAT_HIST)
+  int it;   // число выполненных итераций
+  int retv; // код возврата
+  double f[RFPOS_STAT_HIST];  // модуль невязки |F| перед шагом [м]
+  double dx[RFPOS_STAT_HIST]; // модуль поправки |dx| [м]
+  unsigned long long t0;      // начало решения [нс]
+} rfpos_trace_t;
+//----------------------------------------------------------------------------
+// точки измерения в решателе: при сборке без RFPOS_STATS макросы пусты
+// (нет ни кода, ни полей в `rfpos_t`)
+#ifdef RFPOS_STATS
+#  define RFPOS_STAT_T(v) unsigned long long v = rfpos_stat_ns()
+#  define RFPOS_STAT_BEGIN(self) rfpos_stat_begin(&(self)->trace)
+#  define RFPOS_STAT_END(self, retv) \
+     rfpos_stat_end(&(self)->stat, &(self)->trace, (retv))
+#  define RFPOS_STAT_PHASE(self, ph, v) \
+     rfpos_stat_phase(&(self)->stat, (ph), (v))
+#  define RFPOS_STAT_STEP(self, f, s) \
+     rfpos_stat_step(&(self)->trace, (f), (s))
+#else
+#  define RFPOS_STAT_T(v)
+#  define RFPOS_STAT_BEGIN(self)
+#  define RFPOS_STAT_END(self, retv)
+#  define RFPOS_STAT_PHASE(self, ph, v)
+#  define RFPOS_STAT_STEP(self, f, s) ((void) (f), (void) (s))
+#endif // RFPOS_STATS
+//----------------------------------------------------------------------------
+#ifdef RFPOS_STATS
+//----------------------------------------------------------------------------
+// увеличить счётчик (единственный писатель - поток-владелец)
+#define RFPOS_STAT_ADD(c, v) \
+  __atomic_store_n(&(c), (c) + (unsigned long long) (v), __ATOMIC_RELAXED)
+//----------------------------------------------------------------------------
+// монотонное время [нс]
+static inline unsigned long long rfpos_stat_ns(void)
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (unsigned long long) tv.tv_sec * 1000000000ull +
+         (unsigned long long) tv.tv_nsec;
+}
+//----------------------------------------------------------------------------
+// начало решения
+static inline void rfpos_stat_begin(rfpos_trace_t *h)
+{
+  h->n = h->it = 0;
+  h->t0 = rfpos_stat_ns();
+}
+//----------------------------------------------------------------------------
+// итерация: квадраты модулей невязки f и поправки s
+static inline void rfpos_stat_step(rfpos_trace_t *h, double f, double s)
+{
+  if (h->n < RFPOS_STAT_HIST)
+  {
+    h->f[h->n]  = __builtin_sqrt(f);
+    h->dx[h->n] = __builtin_sqrt(s);
+    h->n++;
+  }
+  h->it++;
+}
+//----------------------------------------------------------------------------
+// фаза итерации, начатая в момент t [нс]
+static inline void rfpos_stat_phase(rfpos_stat_t *c, int ph,
+                                    unsigned long long t)
+{
+  RFPOS_STAT_ADD(c->ph_ns[ph], rfpos_stat_ns() - t);
+  RFPOS_STAT_ADD(c->ph_n[ph], 1);
+}
+//----------------------------------------------------------------------------
+// конец решения с кодом возврата retv (число итераций или ошибка)
+static inline void rfpos_stat_end(rfpos_stat_t *c, rfpos_trace_t *h,
+                                  int retv)
+{
+  unsigned long long ns = rfpos_stat_ns() - h->t0;
+  int k;
+
+  h->retv = retv;
+  RFPOS_STAT_ADD(c->solves, 1);
+  RFPOS_STAT_ADD(c->ns, ns);
+
+  k = retv >= 0 ? 0 : -retv;
+  RFPOS_STAT_ADD(c->ret[k < RFPOS_STAT_RET ? k : RFPOS_STAT_RET - 1], 1);
+
+  k = retv >= 0 ? retv : h->it; // при ошибке - выполненные итерации
+  RFPOS_STAT_ADD(c->iters, k);
+  RFPOS_STAT_ADD(c->h_it[k < RFPOS_STAT_IT ? k : RFPOS_STAT_IT - 1], 1);
+
+  k = ns ? 63 - __builtin_clzll(ns) : 0;
+  RFPOS_STAT_ADD(c->h_ns[k < RFPOS_STAT_NS ? k : RFPOS_STAT_NS - 1], 1);
+}
+//----------------------------------------------------------------------------
+#endif // RFPOS_STATS
+//----------------------------------------------------------------------------
+#endif // RFPOS_STAT_H
+
+/*** end of "rfpos_stat.h" ***/
@@ -0,0 +1,155 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (кэш состояния меток для выбора исходной точки поиска)
+ * Version: 0.1b
+ * File: "rfpos_tag.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+//----------------------------------------------------------------------------
+#include "rfpos_tag.h"
+//----------------------------------------------------------------------------
+// сравнение номера метки ячейки с искомым (для rfpos_lru_find())
+static int rfpos_tag_eq(const void *e, const void *key)
+{
+  return ((const rfpos_tag_entry_t*) e)->tag == *(const unsigned*) key;
+}
+//----------------------------------------------------------------------------
+// инициализация кэша, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_tag_init(
+  rfpos_tag_t *self, // структура данных кэша
+  int max,           // максимальное число меток
+  double dtmax)      // максимальный интервал экстраполяции по скорости [с]
+{
+  self->dtmax = dtmax;
+  self->evict = 0;
+
+  return rfpos_lru_init(&self->lru, max, sizeof(rfpos_tag_entry_t));
+}
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_tag_free(rfpos_tag_t *self)
+{
+  rfpos_lru_free(&self->lru);
+}
+//----------------------------------------------------------------------------
+// найти метку (или NULL); найденная метка становится последней в LRU
+rfpos_tag_entry_t *rfpos_tag_find(rfpos_tag_t *self, unsigned tag)
+{
+  int i = rfpos_lru_find(&self->lru, rfpos_hash(tag), rfpos_tag_eq, &tag);
+  if (i < 0)
+    return (rfpos_tag_entry_t*) 0;
+
+  return (rfpos_tag_entry_t*) RFPOS_LRU_NODE(&self->lru, i);
+}
+//----------------------------------------------------------------------------
+// предполагаемые координаты метки на момент времени t
+// (возвращается 1 - координаты записаны в p, 0 - метка неизвестна)
+int rfpos_tag_guess(
+  rfpos_tag_t *self, // структура данных кэша
+  unsigned tag,      // номер метки
+  int d,             // размерность координат (2 или 3)
+  double t,          // момент времени [с]
+  double *p)         // предполагаемые координаты передатчика [d]
+{
+  int j;
+  double dt;
+  rfpos_tag_entry_t *e = rfpos_tag_find(self, tag);
+
+  if (!e)
+    return 0;
+
+  // экстраполяция по скорости только на коротком интервале
+  dt = t - e->t0;
+  if (!e->nv || dt <= 0. || dt > self->dtmax)
+    dt = 0.;
+
+  for (j = 0; j < d; j++)
+    p[j] = e->r[j] + e->v[j] * dt;
+
+  return 1;
+}
+//----------------------------------------------------------------------------
+// запомнить решение для метки (при необходимости вытесняется метка,
+// дольше всех не использовавшаяся)
+void rfpos_tag_update(
+  rfpos_tag_t *self, // структура данных кэша
+  unsigned tag,      // номер метки
+  int d,             // размерность координат (2 или 3)
+  double t0,         // время излучения сигнала [с]
+  const double *r)   // координаты передатчика [d]
+{
+  int i, j;
+  rfpos_tag_entry_t *e = rfpos_tag_find(self, tag);
+
+  if (e)
+  { // известная метка: обновить скорость по двум последним решениям
+    double dt = t0 - e->t0;
+    e->nv = dt > 0. && dt <= self->dtmax;
+    for (j = 0; j < d; j++)
+    {
+      e->v[j] = e->nv ? (r[j] - e->r[j]) / dt : 0.;
+      e->r[j] = r[j];
+    }
+    if (dt > 0.) e->dt = dt;
+    e->t0 = t0;
+    return;
+  }
+
+  // новая метка (при необходимости вытесняется давно не использованная)
+  i = rfpos_lru_add(&self->lru, rfpos_hash(tag), &self->evict);
+  e = (rfpos_tag_entry_t*) RFPOS_LRU_NODE(&self->lru, i);
+  e->tag  = tag;
+  e->nv   = 0;
+  e->t0   = t0;
+  e->dt   = 0.;
+  for (j = 0; j < d; j++)
+  {
+    e->r[j] = r[j];
+    e->v[j] = 0.;
+  }
+}
+//----------------------------------------------------------------------------
+// rfpos_calc() с исходной точкой из кэша меток
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_tag(
+  rfpos_t *self,      // структура данных компонента
+  rfpos_tag_t *cache, // кэш меток
+  unsigned tag,       // номер метки
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r)  // радиус вектор передатчика [d]
+{
+  int i, retv;
+  double p[RFPOS_D_MAX], tmin;
+
+  if (n < 1)
+    return RFPOS_ERR_FEW; // ошибка: недостаточно приёмников
+
+  // момент излучения не позже самой ранней временной метки
+  tmin = t[0];
+  for (i = 1; i < n; i++)
+    if (tmin > t[i]) tmin = t[i];
+
+  retv = rfpos_calc(self, it, e, d, n, m, t,
+                    rfpos_tag_guess(cache, tag, d, tmin, p) ? p :
+                                                  (const double*) 0,
+                    t0, r);
+
+  if (retv >= 0)
+    rfpos_tag_update(cache, tag, d, *t0, r);
+
+  return retv;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_tag.c" ***/
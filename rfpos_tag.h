@@ -0,0 +1,97 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (кэш состояния меток для выбора исходной точки поиска)
+ * Version: 0.1b
+ * File: "rfpos_tag.h"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+#ifndef RFPOS_TAG_H
+#define RFPOS_TAG_H
+//----------------------------------------------------------------------------
+#include "rfpos.h"     // `rfpos_t`, RFPOS_D_MAX
+#include "rfpos_lru.h" // `rfpos_lru_t`
+//----------------------------------------------------------------------------
+// состояние одной метки (передатчика)
+typedef struct {
+  rfpos_lru_node_t node; // служебная часть ячейки таблицы
+  unsigned tag;          // номер метки
+  int nv;                // 1 - оценка скорости достоверна
+  double t0;             // время излучения последнего решённого импульса [с]
+  double dt;             // интервал между двумя последними импульсами [с]
+  double r[RFPOS_D_MAX]; // последние координаты передатчика [м]
+  double v[RFPOS_D_MAX]; // оценка скорости [м/с]
+} rfpos_tag_entry_t;
+//----------------------------------------------------------------------------
+// кэш меток: хеш-таблица с открытой адресацией (линейное пробирование)
+// и вытеснением давно не обновлявшихся меток (LRU); память фиксирована
+typedef struct {
+  rfpos_lru_t lru; // таблица ячеек `rfpos_tag_entry_t` (lru.cnt - число меток)
+  double dtmax; // максимальный интервал экстраполяции по скорости [с]
+                // (0 - без экстраполяции, берётся последнее положение)
+  long evict;   // число вытесненных меток (статистика)
+} rfpos_tag_t;
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+// инициализация кэша, выделение памяти
+// (в случае ошибки возвращается отрицательный код ошибки)
+int rfpos_tag_init(
+  rfpos_tag_t *self, // структура данных кэша
+  int max,           // максимальное число меток
+  double dtmax);     // максимальный интервал экстраполяции по скорости [с]
+//----------------------------------------------------------------------------
+// освобождение памяти
+void rfpos_tag_free(rfpos_tag_t *self);
+//----------------------------------------------------------------------------
+// найти метку (или NULL); найденная метка становится последней в LRU
+rfpos_tag_entry_t *rfpos_tag_find(rfpos_tag_t *self, unsigned tag);
+//----------------------------------------------------------------------------
+// предполагаемые координаты метки на момент времени t
+// (возвращается 1 - координаты записаны в p, 0 - метка неизвестна)
+int rfpos_tag_guess(
+  rfpos_tag_t *self, // структура данных кэша
+  unsigned tag,      // номер метки
+  int d,             // размерность координат (2 или 3)
+  double t,          // момент времени [с]
+  double *p);        // предполагаемые координаты передатчика [d]
+//----------------------------------------------------------------------------
+// запомнить решение для метки (при необходимости вытесняется метка,
+// дольше всех не использовавшаяся)
+void rfpos_tag_update(
+  rfpos_tag_t *self, // структура данных кэша
+  unsigned tag,      // номер метки
+  int d,             // размерность координат (2 или 3)
+  double t0,         // время излучения сигнала [с]
+  const double *r);  // координаты передатчика [d]
+//----------------------------------------------------------------------------
+// rfpos_calc() с исходной точкой из кэша меток: для известной метки поиск
+// начинается с её последнего (экстраполированного) положения, иначе - как
+// при p=NULL; успешное решение запоминается в кэше
+// (коды возврата как у rfpos_calc())
+int rfpos_calc_tag(
+  rfpos_t *self,      // структура данных компонента
+  rfpos_tag_t *cache, // кэш меток
+  unsigned tag,       // номер метки
+  // на входе:
+  int it,          // максимальное число итераций
+  double e,        // желаемая численная точность оценки координат [м]
+  int d,           // размерность координат (2 или 3)
+  int n,           // число приёмников, принявших сигнал (n > d)
+  const double *m, // матрица координат приёмников [n][d]
+  const double *t, // вектор временных меток приёма сигнала приёмниками [n]
+  // на выходе:
+  double *t0, // оценка времени излучения сигнала передатчиком
+  double *r); // радиус вектор передатчика [d]
+//----------------------------------------------------------------------------
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+//----------------------------------------------------------------------------
+#endif // RFPOS_TAG_H
+
+/*** end of "rfpos_tag.h" ***/
@@ -9,14 +9,34 @@
 
 //----------------------------------------------------------------------------
 #include <stdio.h> // printf()
+#include <math.h> // sqrt()
+#include <string.h> // memcmp()
 #include "rfpos.h" // `rfpos_t`
+#include "rfpos_pool.h" // `rfpos_pool_t`
+#include "rfpos_site.h" // `rfpos_site_t`
+#include "rfpos_tag.h" // `rfpos_tag_t`
+#include "rfpos_assoc.h" // `rfpos_assoc_t`
 //----------------------------------------------------------------------------
 #define MAX_D 3
 #define MAX_N 10
+#define LRU_MAX 6 // ёмкость кэшей в проверке вытеснения (таблица 8 ячеек)
+//----------------------------------------------------------------------------
+// номер последнего завершённого задания для каждой метки (проверка порядка)
+static int pool_last[2] = {-1, -1};
+static int pool_order_err = 0;
+//----------------------------------------------------------------------------
+// функция завершения задания пула (задания с одной меткой - по порядку)
+static void pool_done(rfpos_job_t *job)
+{
+  int seq = *((int*) job->arg);
+  if (seq < pool_last[job->tag])
+    pool_order_err++;
+  pool_last[job->tag] = seq;
+}
 //----------------------------------------------------------------------------
 int main()
 {
-  int retv;
+  int i, retv;
   int d = 3;
   int n = 6; // 4...6
   rfpos_t rfpos;
@@ -48,6 +68,12 @@ int main()
 
   // инициализировать компонент
   rfpos_init(&rfpos, MAX_D, MAX_N);
+
+  // ковариация до первого решения - ошибка, а не чтение мусора
+  {
+    rfpos_cov_t cov;
+    printf("cov: before solve retv = %i\n", rfpos_cov(&rfpos, &cov));
+  }
     
   // вычислить временные метки приёма сигнала для теста (t)
   rfpos_test(d, n, m, q, T0, t);
@@ -69,6 +95,480 @@ int main()
   printf("retv = %i\n", retv);
   printf("r = [%f, %f, %f]\n", r[0], r[1], r[2]);
   printf("t0 = %.8g\n", t0);
+
+#ifdef RFPOS_STATS
+  // история итераций последнего решения: модули невязки и поправки
+  for (i = 0; i < rfpos.trace.n; i++)
+    printf(">>> mod(f)=%g => mod(dx)=%g\n", rfpos.trace.f[i],
+           rfpos.trace.dx[i]);
+#endif // RFPOS_STATS
+
+  // ковариация и геометрические факторы точности решения
+  {
+    rfpos_cov_t cov;
+    retv = rfpos_cov(&rfpos, &cov);
+    printf("cov: retv = %i hdop = %.3f vdop = %.3f tdop = %.3f gdop = %.3f\n",
+           retv, cov.hdop, cov.vdop, cov.tdop, cov.gdop);
+  }
+
+  // пакетное решение: два импульса, разные наборы приёмников
+  {
+    int bn[]   = {6, 4};
+    int bidx[] = {0, 1, 2, 3, 4, 5,  0, 1, 2, 4};
+    double bt[10], bt0[2], br[2 * MAX_D];
+    int bst[2];
+    rfpos_batch_t b = {2, bn, bidx, bt, (const double*) 0, (const double*) 0,
+                       bt0, br, bst};
+
+    rfpos_test(d, n, m, q, T0, bt);        // импульс 1 (все приёмники)
+    rfpos_test(d, n, m, q, T0 + 1e-3, t);  // импульс 2 (приёмники 0,1,2,4)
+    bt[6] = t[0]; bt[7] = t[1]; bt[8] = t[2]; bt[9] = t[4];
+
+    retv = rfpos_calc_batch(&rfpos, 30, 1e-4, d, m, &b);
+    printf("batch: retv = %i\n", retv);
+    for (i = 0; i < b.k; i++)
+      printf("st = %i r = [%f, %f, %f] t0 = %.8g\n",
+             bst[i], br[i * d], br[i * d + 1], br[i * d + 2], bt0[i]);
+  }
+
+  // смешанная точность: итерации в float, уточнение в double
+  {
+    int bn[] = {6};
+    int bidx[] = {0, 1, 2, 3, 4, 5};
+    float fm[6 * MAX_D], ft[6];
+    double tb[1], bt0[1], br[MAX_D];
+    int bst[1];
+    rfpos_batch_f_t b = {1, bn, bidx, tb, ft, (const float*) 0,
+                         (const float*) 0, bt0, br, bst};
+
+    rfpos_test(d, n, m, q, T0, t);
+    rfpos.opt = RFPOS_OPT_F32;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    rfpos.opt = RFPOS_OPT_NONE;
+    printf("f32: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           r[0], r[1], r[2], t0);
+#ifdef RFPOS_STATS
+    // история включает итерации одинарной точности с их поправками
+    for (i = 0; i < rfpos.trace.n; i++)
+      printf("f32: >>> mod(f)=%.3g => mod(dx)=%.3g\n", rfpos.trace.f[i],
+             rfpos.trace.dx[i]);
+#endif // RFPOS_STATS
+
+    // местные координаты площадки (начало - в первом приёмнике) и
+    // смещения меток от первой метки
+    for (i = 0; i < n * d; i++)
+      fm[i] = (float) (m[i] - m[i % d]);
+    tb[0] = t[0];
+    for (i = 0; i < n; i++)
+      ft[i] = (float) (t[i] - tb[0]);
+    retv = rfpos_calc_batch_f(&rfpos, 30, 1e-4, d, m, fm, &b);
+    printf("batch_f: retv = %i st = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           bst[0], br[0], br[1], br[2], bt0[0]);
+  }
+
+  // шаг Гаусса-Ньютона разложением QR вместо нормальных уравнений
+  {
+    rfpos_test(d, n, m, q, T0, t);
+    rfpos.opt = RFPOS_OPT_QR;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    rfpos.opt = RFPOS_OPT_NONE;
+    printf("qr: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           r[0], r[1], r[2], t0);
+  }
+
+  // метод хорд: разложение нормальной матрицы сохраняется между итерациями
+  {
+    rfpos_test(d, n, m, q, T0, t);
+    rfpos.opt = RFPOS_OPT_CHORD;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    rfpos.opt = RFPOS_OPT_NONE;
+    printf("chord: retv = %i r = [%f, %f, %f] t0 = %.8g nc = %i\n", retv,
+           r[0], r[1], r[2], t0, rfpos.nc);
+  }
+
+  // разности дальностей: d0 исключается, система 3x3 вместо 4x4; при
+  // шумах взвешенное решение - стационарная точка обобщённого МНК по
+  // разностям с корреляционной матрицей (шаг la_svd_full() равен нулю)
+  {
+    double s[MAX_N], dx2 = 0., r0, ri;
+    int j, err;
+    la_matrix_t a, cn;
+    la_vector_t f, dx;
+
+    rfpos_test(d, n, m, q, T0, t);
+    rfpos.opt = RFPOS_OPT_TDOA;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    printf("tdoa: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           r[0], r[1], r[2], t0);
+
+    for (i = 0; i < n; i++)
+    {
+      s[i] = 1e-11 * (1 + i);
+      t[i] += i & 1 ? s[i] : -s[i];
+    }
+    retv = rfpos_calc_w(&rfpos, 30, 1e-6, d, n, m, t, s, p, &t0, r);
+    rfpos.opt = RFPOS_OPT_NONE;
+
+    la_matrix_init(&a, n - 1, d);
+    la_matrix_init(&cn, n - 1, n - 1);
+    la_vector_init(&f, n - 1);
+    for (j = 0, r0 = 0.; j < d; j++)
+      r0 += (r[j] - m[j]) * (r[j] - m[j]);
+    r0 = sqrt(r0);
+    for (i = 1; i < n; i++)
+    {
+      for (j = 0, ri = 0.; j < d; j++)
+        ri += (r[j] - m[i * d + j]) * (r[j] - m[i * d + j]);
+      ri = sqrt(ri);
+      for (j = 0; j < d; j++)
+        a.d[i - 1][j] = (r[j] - m[i * d + j]) / ri - (r[j] - m[j]) / r0;
+      f.d[i - 1] = ri - r0 - (t[i] - t[0]) * RFPOS_C;
+      for (j = 1; j < n; j++)
+        cn.d[i - 1][j - 1] = (s[0] * s[0] + (i == j ? s[i] * s[i] : 0.)) *
+                             RFPOS_C * RFPOS_C;
+    }
+    dx = la_svd_full(&a, &f, &cn, &err);
+    for (j = 0; j < d; j++)
+      dx2 += dx.d[j] * dx.d[j];
+    printf("tdoa: weighted retv = %i r = [%f, %f, %f] la_svd_full step = "
+           "%.1e m (err = %i)\n", retv, r[0], r[1], r[2], sqrt(dx2), err);
+    la_vector_free(&dx);
+    la_vector_free(&f);
+    la_matrix_free(&cn);
+    la_matrix_free(&a);
+  }
+
+  // опоздавшее обнаружение: импульс решён по 5 приёмникам, шестой
+  // добавляется изменением разложения на ранг 1 и одной итерацией;
+  // затем приёмник 1 исключается (сравнение с полным решением)
+  {
+    double t1[MAX_N], m1[MAX_N * MAX_D], rf[MAX_D], tf;
+    int j, k;
+
+    rfpos_test(d, n, m, q, T0, t);
+    for (i = 0; i < n; i++)
+      t[i] += (i & 1 ? 1e-11 : -1e-11) * (1 + i);
+
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n - 1, m, t, p, &t0, r);
+    retv = rfpos_calc_add(&rfpos, m + (n - 1) * d, t[n - 1], 0., &t0, r);
+    rfpos_calc(&rfpos, 30, 1e-6, d, n, m, t, p, &tf, rf);
+    printf("late: add retv = %i r = [%f, %f, %f] full = [%f, %f, %f]\n", retv,
+           r[0], r[1], r[2], rf[0], rf[1], rf[2]);
+
+    // порядок после исключения: последний приёмник на месте первого
+    for (i = 0; i < n; i++)
+    {
+      k = i == 1 ? n - 1 : i;
+      t1[i] = t[k];
+      for (j = 0; j < d; j++)
+        m1[i * d + j] = m[k * d + j];
+    }
+    retv = rfpos_calc_del(&rfpos, 1, &t0, r);
+    rfpos_calc(&rfpos, 30, 1e-6, d, n - 1, m1, t1, p, &tf, rf);
+    printf("late: del retv = %i r = [%f, %f, %f] full = [%f, %f, %f]\n", retv,
+           r[0], r[1], r[2], rf[0], rf[1], rf[2]);
+
+    // решение с грубой точностью (итерации остановлены по поправке, ws.a -
+    // разложение в точке до последнего шага): разложение для добавления
+    // строится заново в возвращённой точке
+    rfpos_calc(&rfpos, 30, 1e-1, d, n - 1, m, t, p, &t0, r);
+    retv = rfpos_calc_add(&rfpos, m + (n - 1) * d, t[n - 1], 0., &t0, r);
+    rfpos_calc(&rfpos, 30, 1e-6, d, n, m, t, p, &tf, rf);
+    for (j = 0, tf = 0.; j < d; j++)
+      tf += (r[j] - rf[j]) * (r[j] - rf[j]);
+    printf("late: add after coarse solve retv = %i |r - full| = %.1e m\n",
+           retv, sqrt(tf));
+
+    // взвешенный импульс: добавление без СКО и исключение несуществующего
+    // приёмника - неверные аргументы, а не отсутствие решения
+    for (i = 0; i < n; i++)
+      t1[i] = 1e-9;
+    rfpos_calc_w(&rfpos, 30, 1e-4, d, n - 1, m, t, t1, p, &t0, r);
+    retv = rfpos_calc_add(&rfpos, m + (n - 1) * d, t[n - 1], 0., &t0, r);
+    k    = rfpos_calc_del(&rfpos, n, &t0, r);
+    printf("late: add without sigma retv = %i del of missing retv = %i\n",
+           retv, k);
+  }
+
+  // срок решения: истёкший срок - лучшее приближение и RFPOS_ERR_TIME,
+  // пакет со сроками - импульсы по возрастанию срока (EDF)
+  {
+    int bn[] = {6, 6, 6};
+    int bidx[] = {0, 1, 2, 3, 4, 5,  0, 1, 2, 3, 4, 5,  0, 1, 2, 3, 4, 5};
+    int bst[3], ord[3];
+    double bt[18], bt0[3], br[3 * MAX_D], tdl[3];
+    rfpos_batch_t b = {3, bn, bidx, bt, (const double*) 0, (const double*) 0,
+                       bt0, br, bst, (rfpos_cov_t*) 0, tdl, ord};
+
+    rfpos_test(d, n, m, q, T0, t);
+    rfpos.tdl = rfpos_time() - 1.;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    printf("deadline: expired retv = %i\n", retv);
+    rfpos.tdl = rfpos_time() + 1.;
+    retv = rfpos_calc(&rfpos, 30, 1e-4, d, n, m, t, p, &t0, r);
+    printf("deadline: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           r[0], r[1], r[2], t0);
+    rfpos.tdl = 0.;
+
+    for (i = 0; i < 3; i++)
+      rfpos_test(d, n, m, q, T0 + 1e-3 * i, bt + 6 * i);
+    tdl[0] = rfpos_time() + 2.;
+    tdl[1] = rfpos_time() + 1.;
+    tdl[2] = 0.; // без срока - последним
+    retv = rfpos_calc_batch(&rfpos, 30, 1e-4, d, m, &b);
+    printf("deadline: batch retv = %i ord = %i %i %i st = %i %i %i\n", retv,
+           ord[0], ord[1], ord[2], bst[0], bst[1], bst[2]);
+
+    // сроки без массива порядка - ошибка описания пакета
+    b.ord = (int*) 0;
+    retv = rfpos_calc_batch(&rfpos, 30, 1e-4, d, m, &b);
+    printf("deadline: batch without ord retv = %i\n", retv);
+  }
+
+  // робастное решение: сигнал до приёмника 1 задержан на 5 м (многолучёвость)
+  {
+    unsigned char in[MAX_N];
+
+    rfpos_test(d, n, m, q, T0, t);
+    t[1] += 5. / RFPOS_C;
+
+    retv = rfpos_calc_ransac(&rfpos, 30, 1e-4, d, n, m, t, 0.1, 0,
+                             &t0, r, in);
+    printf("ransac: retv = %i r = [%f, %f, %f] t0 = %.8g in =", retv,
+           r[0], r[1], r[2], t0);
+    for (i = 0; i < n; i++)
+      printf(" %i", in[i]);
+    printf("\n");
+  }
+
+  // известная высота передатчика (z = 5 м): достаточно трёх приёмников
+  {
+    rfpos_pair_t pair;
+
+    rfpos_test(d, n, m, q, T0, t);
+    retv = rfpos_calc_fix(&rfpos, 30, 1e-4, d, 3, m, t, 2, q[2], p, &t0, r);
+    printf("fix: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+           r[0], r[1], r[2], t0);
+
+    // только два приёмника: гипербола и пеленг
+    retv = rfpos_calc_pair(d, m, t, &pair);
+    printf("pair: retv = %i a = %f c = %f naz = %i az = [%f, %f]\n", retv,
+           pair.a, pair.c, pair.naz, pair.az[0], pair.az[1]);
+  }
+
+  // кэш подмножеств: три импульса от приёмников {0,1,2,4} и {0,1,2,3,4}
+  // в разном порядке прихода сигнала (второй импульс - из кэша)
+  {
+    rfpos_site_t site;
+    int sidx[3][5] = {{4, 0, 2, 1}, {2, 1, 0, 4}, {3, 0, 4, 1, 2}};
+    int sn[3] = {4, 4, 5};
+    double st[5];
+
+    rfpos_site_init(&site, d, n, m, 16);
+    rfpos_test(d, n, m, q, T0, t);
+    for (i = 0; i < 3; i++)
+    {
+      int j;
+      for (j = 0; j < sn[i]; j++)
+        st[j] = t[sidx[i][j]];
+      retv = rfpos_calc_site(&rfpos, &site, 30, 1e-4, sn[i], sidx[i], st,
+                             (const double*) 0, (const double*) 0, &t0, r);
+      printf("site: retv = %i r = [%f, %f, %f] t0 = %.8g\n", retv,
+             r[0], r[1], r[2], t0);
+    }
+    printf("site: hit = %li miss = %li\n", site.hit, site.miss);
+    rfpos_site_free(&site);
+  }
+
+  // переполнение кэшей: 16 меток и 21 подмножество из 4-5 приёмников на
+  // LRU_MAX мест (таблица заполнена на 3/4, цепочки пробирования длинные);
+  // после каждого обращения кэш сверяется с эталонным списком LRU -
+  // вытесняется давно не использованный ключ, оставшиеся находятся и после
+  // удалений со сдвигом цепочек назад
+  {
+    rfpos_tag_t tc;
+    rfpos_tag_entry_t *te;
+    rfpos_site_t site;
+    rfpos_sub_t sub;
+    const rfpos_sub_t *ps;
+    unsigned seed = 1, key, lru[LRU_MAX + 1], masks[21];
+    int k, j, b, nl, nm = 0, lost = 0, extra = 0, wrong = 0, sidx[MAX_N];
+    double kr[16], tr[MAX_D] = {0., 0., 0.};
+    long hit;
+
+    rfpos_tag_init(&tc, LRU_MAX, 0.);
+    for (k = 0, nl = 0; k < 2000; k++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      key = (seed >> 16) % 16;
+      tr[0] = kr[key] = k;
+      rfpos_tag_update(&tc, key, d, k * 1e-3, tr);
+
+      // эталон: key - в начало списка, при переполнении теряется последний
+      for (j = 0; j < nl && lru[j] != key; j++);
+      if (j == nl && nl < LRU_MAX) nl++;
+      if (j == LRU_MAX) j--;
+      for (; j > 0; j--) lru[j] = lru[j - 1];
+      lru[0] = key;
+
+      // поиск от давних к последним сохраняет порядок LRU
+      for (j = nl - 1; j >= 0; j--)
+        if (!(te = rfpos_tag_find(&tc, lru[j])) || te->r[0] != kr[lru[j]])
+          lost++;
+      for (key = 0; key < 16; key++)
+      {
+        for (j = 0; j < nl && lru[j] != key; j++);
+        if (j == nl && rfpos_tag_find(&tc, key))
+          extra++;
+      }
+    }
+    printf("lru: tag evict = %li lost = %i extra = %i cnt = %i\n",
+           tc.evict, lost, extra, tc.lru.cnt);
+
+    // известная метка: поиск начинается с запомненного положения (метка
+    // с шумом - линеаризованное решение не совпадает с решением МНК)
+    rfpos_test(d, n, m, q, T0, t);
+    t[1] += 1e-9;
+    retv = rfpos_calc_tag(&rfpos, &tc, 100, 30, 1e-4, d, n, m, t, &t0, r);
+    i    = rfpos_calc_tag(&rfpos, &tc, 100, 30, 1e-4, d, n, m, t, &t0, r);
+    printf("lru: calc_tag retv = %i (new) %i (cached) r = [%f, %f, %f]\n",
+           retv, i, r[0], r[1], r[2]);
+    rfpos_tag_free(&tc);
+
+    // подмножества: данные найденного подмножества совпадают с вычисленными
+    // заново, попадания - с эталоном
+    for (k = 0; k < 1 << n; k++)
+    {
+      for (b = k, j = 0; b; b &= b - 1) j++;
+      if (j == d + 1 || j == d + 2) masks[nm++] = k;
+    }
+    rfpos_site_init(&site, d, n, m, LRU_MAX);
+    lost = 0;
+    for (k = 0, nl = 0; k < 2000; k++)
+    {
+      seed = seed * 1103515245u + 12345u;
+      key = masks[(seed >> 16) % nm];
+      hit = site.hit;
+      ps = rfpos_site_sub(&site, key);
+
+      for (j = 0; j < nl && lru[j] != key; j++);
+      if ((j < nl) != (site.hit > hit))
+        lost++;
+      if (j == nl && nl < LRU_MAX) nl++;
+      if (j == LRU_MAX) j--;
+      for (; j > 0; j--) lru[j] = lru[j - 1];
+      lru[0] = key;
+
+      for (b = 0, j = 0; b < n; b++)
+        if (key >> b & 1) sidx[j++] = b;
+      rfpos_sub_init(&sub, d, j, m, sidx);
+      if (!ps || ps->n != j || ps->ok != sub.ok || (sub.ok &&
+          (j > d + 1 ? memcmp(ps->gi, sub.gi, sizeof(sub.gi)) :
+                       memcmp(ps->pp, sub.pp, sizeof(sub.pp)))))
+        wrong++;
+    }
+    printf("lru: site hit = %li miss = %li evict = %li lost = %i wrong = %i\n",
+           site.hit, site.miss, site.evict, lost, wrong);
+    rfpos_site_free(&site);
+  }
+
+  // ассоциация: три импульса через 0.2 мкс без номеров импульсов; потоки
+  // приёмников приходят вперемешку, метки приёмника 0 - с опозданием и
+  // не по порядку, приёмник 3 пропустил второй импульс; затем опоздавшее
+  // обнаружение предыдущего импульса
+  {
+    rfpos_assoc_t as;
+    int aidx[MAX_N], k, j, ord[3] = {0, 2, 1};
+    double at[MAX_N], am[MAX_N * MAX_D], pt[4][MAX_N];
+
+    retv = rfpos_assoc_init(&as, d, n, m, 8, 5e-7, 1e-9, d + 1);
+    for (k = 0; k < 4; k++)
+      rfpos_test(d, n, m, q, T0 + 2e-7 * (k - 1), pt[k]);
+    for (k = 1; k < 4; k++)
+      for (i = n - 1; i > 0; i--)
+        if (i != 3 || k != 2)
+          rfpos_assoc_push(&as, i, pt[k][i]);
+    for (k = 0; k < 3; k++)
+      rfpos_assoc_push(&as, 0, pt[ord[k] + 1][0]);
+    printf("assoc: retv = %i late = %i\n", retv,
+           rfpos_assoc_push(&as, 3, pt[0][3]) == RFPOS_ASSOC_ERR_LATE);
+
+    rfpos_assoc_flush(&as);
+    while ((k = rfpos_assoc_pop(&as, aidx, at)) > 0)
+    {
+      for (i = 0; i < k; i++)
+        for (j = 0; j < d; j++)
+          am[i * d + j] = m[aidx[i] * d + j];
+      retv = rfpos_calc(&rfpos, 30, 1e-4, d, k, am, at, (const double*) 0,
+                        &t0, r);
+      printf("assoc: n = %i retv = %i r = [%f, %f, %f] t0 = %.8g\n", k, retv,
+             r[0], r[1], r[2], t0);
+    }
+    printf("assoc: groups = %li late = %li drop = %li\n",
+           as.groups, as.late, as.drop);
+    rfpos_assoc_free(&as);
+  }
+
+  // пул решателей: 2 потока, 8 импульсов от двух источников (меток)
+  {
+    rfpos_pool_t pool;
+    rfpos_stat_t st;
+    rfpos_job_t job[8];
+    double pt[8][MAX_N];
+    int seq[8];
+
+    retv = rfpos_pool_init(&pool, 2, 0, MAX_D, MAX_N, pool_done);
+    printf("pool: retv = %i\n", retv);
+
+    for (i = 0; i < 8; i++)
+    {
+      rfpos_test(d, n, m, q, T0 + 1e-3 * i, pt[i]);
+      seq[i] = i;
+      job[i].tag = i & 1;
+      job[i].it  = 30;
+      job[i].e   = 1e-4;
+      job[i].d   = d;
+      job[i].n   = n;
+      job[i].m   = m;
+      job[i].idx = (const int*) 0;
+      job[i].t   = pt[i];
+      job[i].s   = (const double*) 0;
+      job[i].p   = (const double*) 0;
+      job[i].arg = seq + i;
+      job[i].cov = (rfpos_cov_t*) 0;
+      job[i].tdl = i & 1 ? rfpos_time() + 10. : 0.; // метка 1 - со сроком
+      rfpos_pool_submit(&pool, job + i);
+    }
+
+    rfpos_pool_wait(&pool);
+    for (i = 0; i < 8; i++)
+      printf("tag = %u st = %i r = [%f, %f, %f] t0 = %.8g\n", job[i].tag,
+             job[i].st, job[i].r[0], job[i].r[1], job[i].r[2], job[i].t0);
+    printf("pool: order errors = %i\n", pool_order_err);
+
+    rfpos_pool_stat(&pool, &st);
+    printf("pool: stat solves = %llu\n", st.solves);
+
+    rfpos_pool_free(&pool);
+  }
+
+  // счётчики решателя (сборка с RFPOS_STATS)
+  {
+    rfpos_stat_t st;
+    if (rfpos_stat_get(&rfpos, &st))
+    {
+      printf("stat: solves = %llu iters = %llu ok = %llu", st.solves,
+             st.iters, st.ret[0]);
+      for (i = 1; i < RFPOS_STAT_RET; i++)
+        if (st.ret[i])
+          printf(" err%i = %llu", -i, st.ret[i]);
+      printf("\nstat: it =");
+      for (i = 0; i < RFPOS_STAT_IT; i++)
+        if (st.h_it[i])
+          printf(" %i:%llu", i, st.h_it[i]);
+      printf("\n");
+    }
+  }
  
   // деинициализировать компонент
   rfpos_free(&rfpos);
@@ -0,0 +1,712 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * Version: 0.1b
+ * File: "rfpos_bench.cpp" (замеры производительности)
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+//----------------------------------------------------------------------------
+#include <stdio.h>   // printf(), fprintf(), freopen()
+#include <stdlib.h>  // rand()
+#include <math.h>    // fabs(), sqrt()
+#include <time.h>    // clock_gettime()
+#include <unistd.h>  // sysconf(), unlink()
+#include <algorithm> // std::sort()
+#include "rfpos.h"   // rfpos_calc(), rfpos_calc_ransac()
+#include "rfpos.hpp" // rfpos::Solver
+#include "rfpos_pool.h" // rfpos_pool_t
+#include "rfpos_tag.h"  // rfpos_calc_tag()
+#include "rfpos_site.h" // rfpos_calc_site()
+#include "rfpos_grid.h" // rfpos_calc_grid()
+#include "rfpos_assoc.h" // rfpos_assoc_push(), rfpos_assoc_pop()
+//----------------------------------------------------------------------------
+#define D 3  // размерность
+#define N 6  // число приёмников
+#define K 20000 // число решений в замере
+#define TAGS 256 // число источников (меток) в замере пула решателей
+#define MOVE 64  // число движущихся меток в замере кэша меток
+#define BEAT 0.1 // период излучения меток [с]
+#define NF 256   // число приёмников в замере смешанной точности
+//----------------------------------------------------------------------------
+// координаты приёмников (как в "rfpos_test.c")
+static const double m[N * D] = {
+   0.,  0., 3.,
+  20.,  0., 3.,
+  20., 10., 3.,
+   0., 10., 3.,
+  10.,  5., 6.,
+  10., -5., 2.};
+//----------------------------------------------------------------------------
+static double t[K][N];  // временные метки
+static double q[K][D];  // истинные координаты передатчиков
+static double r1[K][D]; // решения rfpos_calc()
+static double r2[K][D]; // решения rfpos::Solver<>
+static rfpos_job_t job[K]; // задания пула решателей
+//----------------------------------------------------------------------------
+// обнаружение приёмника в порядке доставки (замер ассоциатора)
+typedef struct {
+  double a; // время доставки [с]
+  double t; // временная метка [с]
+  int i;    // индекс приёмника
+} det_t;
+static det_t det[K * N];
+//----------------------------------------------------------------------------
+// сравнение обнаружений по времени доставки (для qsort())
+static int det_cmp(const void *a, const void *b)
+{
+  double da = ((const det_t*) a)->a, db = ((const det_t*) b)->a;
+  return da < db ? -1 : da > db;
+}
+//----------------------------------------------------------------------------
+// монотонное время [с]
+static double get_time()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return ((double) tv.tv_sec) + ((double) tv.tv_nsec) * 1e-9;
+}
+//----------------------------------------------------------------------------
+// случайное число в диапазоне [a, b]
+static double frand(double a, double b)
+{
+  return a + (b - a) * ((double) rand() / (double) RAND_MAX);
+}
+//----------------------------------------------------------------------------
+int main()
+{
+  int i, j, it1 = 0, it2 = 0, nc = 0;
+  double t0, t1, t2, err = 0.;
+  const double p[D] = {10., 5., 0.};
+  rfpos_t rfpos;
+  rfpos::Solver<D, 8> solver;
+
+  // сформировать тестовые импульсы внутри помещения
+  for (i = 0; i < K; i++)
+  {
+    q[i][0] = frand(-5., 25.);
+    q[i][1] = frand(-5., 25.);
+    q[i][2] = frand( 0.,  6.);
+    rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+  }
+
+  // отладочная печать rfpos_calc() не должна влиять на замер
+  if (!freopen("/dev/null", "w", stdout))
+    return 1;
+
+  rfpos_init(&rfpos, D, 8);
+
+  t1 = get_time();
+  for (i = 0; i < K; i++)
+    it1 += rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], p, &t0, r1[i]);
+  t1 = get_time() - t1;
+
+  t2 = get_time();
+  for (i = 0; i < K; i++)
+    it2 += solver.calc(30, 1e-4, N, m, t[i], p, &t0, r2[i]);
+  t2 = get_time() - t2;
+
+  for (i = 0; i < K; i++)
+    for (j = 0; j < D; j++)
+      if (err < fabs(r1[i][j] - r2[i][j]))
+        err = fabs(r1[i][j] - r2[i][j]);
+
+  fprintf(stderr, "d=%i n=%i solves=%i\n", D, N, K);
+  fprintf(stderr, "rfpos_calc():        %8.1f ns/solve (iterations: %i)\n",
+          t1 * 1e9 / K, it1);
+  fprintf(stderr, "rfpos::Solver<3,8>:  %8.1f ns/solve (iterations: %i)\n",
+          t2 * 1e9 / K, it2);
+  fprintf(stderr, "speedup: %.2f, max |r1 - r2| = %g m\n", t1 / t2, err);
+
+  // шаг Гаусса-Ньютона разложением QR вместо нормальных уравнений
+  rfpos.opt = RFPOS_OPT_QR;
+  it2 = 0;
+  t2 = get_time();
+  for (i = 0; i < K; i++)
+    it2 += rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], p, &t0, r2[i]);
+  t2 = get_time() - t2;
+  rfpos.opt = RFPOS_OPT_NONE;
+
+  err = 0.;
+  for (i = 0; i < K; i++)
+    for (j = 0; j < D; j++)
+      if (err < fabs(r1[i][j] - r2[i][j]))
+        err = fabs(r1[i][j] - r2[i][j]);
+  fprintf(stderr, "RFPOS_OPT_QR:        %8.1f ns/solve (iterations: %i, "
+          "max |r1 - r2| = %g m)\n", t2 * 1e9 / K, it2, err);
+
+  // метод хорд: разложение нормальной матрицы сохраняется между итерациями
+  rfpos.opt = RFPOS_OPT_CHORD;
+  it2 = nc = 0;
+  t2 = get_time();
+  for (i = 0; i < K; i++)
+  {
+    it2 += rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], p, &t0, r2[i]);
+    nc += rfpos.nc;
+  }
+  t2 = get_time() - t2;
+  rfpos.opt = RFPOS_OPT_NONE;
+
+  err = 0.;
+  for (i = 0; i < K; i++)
+    for (j = 0; j < D; j++)
+      if (err < fabs(r1[i][j] - r2[i][j]))
+        err = fabs(r1[i][j] - r2[i][j]);
+  fprintf(stderr, "RFPOS_OPT_CHORD:     %8.1f ns/solve (iterations: %i, "
+          "max |r1 - r2| = %g m)\n", t2 * 1e9 / K, it2, err);
+  fprintf(stderr, "RFPOS_OPT_CHORD:     %i of %i passes without normal matrix\n",
+          nc, it2 + K);
+
+  // масштабирование пула решателей по числу потоков
+  fprintf(stderr, "\nrfpos_pool: %i tags, %li CPU online\n",
+          TAGS, sysconf(_SC_NPROCESSORS_ONLN));
+  for (i = 0; i < K; i++)
+  {
+    job[i].tag = i % TAGS;
+    job[i].it  = 30;
+    job[i].e   = 1e-4;
+    job[i].d   = D;
+    job[i].n   = N;
+    job[i].m   = m;
+    job[i].idx = (const int*) 0;
+    job[i].t   = t[i];
+    job[i].s   = (const double*) 0;
+    job[i].p   = p;
+    job[i].arg = (void*) 0;
+    job[i].cov = (rfpos_cov_t*) 0;
+  }
+  for (int th = 1; th <= 64; th *= 2)
+  {
+    rfpos_pool_t pool;
+    long stolen = 0;
+    if (rfpos_pool_init(&pool, th, 0, D, 8, (rfpos_done_t) 0) < 0)
+      return 1;
+
+    t2 = get_time();
+    for (i = 0; i < K; i++)
+      rfpos_pool_submit(&pool, &job[i]);
+    rfpos_pool_wait(&pool);
+    t2 = get_time() - t2;
+
+    for (i = 0; i < th; i++)
+      stolen += pool.w[i].stolen;
+    rfpos_pool_free(&pool);
+
+    if (th == 1) t0 = t2;
+    fprintf(stderr, "threads=%2i: %8.1f ns/solve %10.0f solves/s "
+            "(scaling: %5.2f, stolen: %li)\n",
+            th, t2 * 1e9 / K, K / t2, t0 / t2, stolen);
+  }
+
+  // кэш меток: MOVE меток медленно (до 1 м/с) движутся внутри помещения
+  {
+    double q0[MOVE][D], v[MOVE][D];
+    rfpos_tag_t cache;
+
+    for (i = 0; i < MOVE; i++)
+      for (j = 0; j < D; j++)
+      {
+        q0[i][j] = frand(0., 10.);
+        v[i][j]  = frand(-1., 1.);
+      }
+    for (i = 0; i < K; i++)
+    {
+      int k = i % MOVE;
+      double s = (double) (i / MOVE) * BEAT + k * 1e-3;
+      for (j = 0; j < D; j++)
+        q[i][j] = q0[k][j] + v[k][j] * s;
+      rfpos_test(D, N, m, q[i], s, t[i]);
+    }
+
+    it1 = 0;
+    t1 = get_time();
+    for (i = 0; i < K; i++)
+      it1 += rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], p, &t0, r1[i]);
+    t1 = get_time() - t1;
+
+    rfpos_tag_init(&cache, 1024, 1.);
+    it2 = 0;
+    t2 = get_time();
+    for (i = 0; i < K; i++)
+      it2 += rfpos_calc_tag(&rfpos, &cache, i % MOVE, 30, 1e-4, D, N, m,
+                            t[i], &t0, r2[i]);
+    t2 = get_time() - t2;
+    rfpos_tag_free(&cache);
+
+    fprintf(stderr, "\nrfpos_tag: %i moving tags, beacon period %g s\n",
+            MOVE, BEAT);
+    fprintf(stderr, "fixed p:         %8.1f ns/solve (%.2f iterations/solve)\n",
+            t1 * 1e9 / K, (double) it1 / K);
+    fprintf(stderr, "rfpos_calc_tag(): %7.1f ns/solve (%.2f iterations/solve)\n",
+            t2 * 1e9 / K, (double) it2 / K);
+  }
+
+  // робастный режим: сигнал до одного из приёмников задержан на 2...10 м
+  {
+    double e1 = 0., e2 = 0.;
+    unsigned char in[N];
+
+    for (i = 0; i < K; i++)
+      t[i][i % N] += frand(2., 10.) / RFPOS_C;
+
+    t1 = get_time();
+    for (i = 0; i < K; i++)
+      rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], p, &t0, r1[i]);
+    t1 = get_time() - t1;
+
+    t2 = get_time();
+    for (i = 0; i < K; i++)
+      rfpos_calc_ransac(&rfpos, 30, 1e-4, D, N, m, t[i], 0.1, 0,
+                        &t0, r2[i], in);
+    t2 = get_time() - t2;
+
+    for (i = 0; i < K; i++)
+    {
+      double s1 = 0., s2 = 0.;
+      for (j = 0; j < D; j++)
+      {
+        s1 += (r1[i][j] - q[i][j]) * (r1[i][j] - q[i][j]);
+        s2 += (r2[i][j] - q[i][j]) * (r2[i][j] - q[i][j]);
+      }
+      e1 += sqrt(s1);
+      e2 += sqrt(s2);
+    }
+
+    fprintf(stderr, "\nrfpos_calc_ransac(): 1 of %i receivers delayed\n", N);
+    fprintf(stderr, "rfpos_calc():        %8.1f ns/solve (mean error %g m)\n",
+            t1 * 1e9 / K, e1 / K);
+    fprintf(stderr, "rfpos_calc_ransac(): %8.1f ns/solve (mean error %g m)\n",
+            t2 * 1e9 / K, e2 / K);
+  }
+
+  // кэш подмножеств: импульс принимают n из N приёмников (приёмники
+  // перечислены в порядке прихода сигнала), исходная точка не задана
+  for (int n = N - 1; n >= D + 1; n--)
+  {
+    static int idx[K][N];
+    double ts[K][N];
+    rfpos_site_t site;
+
+    for (i = 0; i < K; i++)
+    {
+      int k, used[N] = {0};
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < n; j++)
+      {
+        do k = rand() % N; while (used[k]);
+        used[k] = 1;
+        idx[i][j] = k;
+        ts[i][j] = t[i][k] + frand(-1., 1.) * 1e-10; // шум до 3 см
+      }
+    }
+
+    it1 = 0;
+    t1 = get_time();
+    for (i = 0; i < K; i++)
+      it1 += rfpos_calc_sub(&rfpos, (const rfpos_sub_t*) 0, 30, 1e-4, D, n,
+                            m, idx[i], ts[i], (const double*) 0,
+                            (const double*) 0, &t0, r1[i]);
+    t1 = get_time() - t1;
+
+    rfpos_site_init(&site, D, N, m, 64);
+    it2 = 0;
+    t2 = get_time();
+    for (i = 0; i < K; i++)
+      it2 += rfpos_calc_site(&rfpos, &site, 30, 1e-4, n, idx[i], ts[i],
+                             (const double*) 0, (const double*) 0,
+                             &t0, r2[i]);
+    t2 = get_time() - t2;
+
+    err = 0.;
+    for (i = 0; i < K; i++)
+      for (j = 0; j < D; j++)
+        if (err < fabs(r1[i][j] - r2[i][j]))
+          err = fabs(r1[i][j] - r2[i][j]);
+
+    if (n == N - 1)
+      fprintf(stderr, "\nrfpos_site: n of %i receivers, p = NULL\n", N);
+    fprintf(stderr, "n=%i rfpos_calc_sub(NULL): %7.1f ns/solve "
+            "(%.2f iterations/solve)\n", n, t1 * 1e9 / K, (double) it1 / K);
+    fprintf(stderr, "n=%i rfpos_calc_site():    %7.1f ns/solve "
+            "(%.2f iterations/solve, hit %ld, miss %ld, max |r1 - r2| = %g m)\n",
+            n, t2 * 1e9 / K, (double) it2 / K, site.hit, site.miss, err);
+    rfpos_site_free(&site);
+  }
+
+  // сетка дальностей: холодный старт для передатчиков вне помещения
+  // (на удалении 20...50 м от его центра), импульс принимают N - 1
+  // приёмников, шум временных меток до 1 нс (30 см); решение считается
+  // ошибочным, если оно не совпадает с решением из истинной точки
+  {
+    static const char *fname = "rfpos_bench.grid";
+    static const double lo[D] = {-50., -55., 0.};
+    static const double hi[D] = { 70.,  65., 6.};
+    static const int idx[N] = {0, 1, 2, 3, 4, 5};
+    const int n = N - 1, kg = K / 10;
+    int w1 = 0, w2 = 0;
+    double rr[D];
+    rfpos_grid_t grid;
+
+    for (i = 0; i < kg; i++)
+    {
+      double a = frand(0., 2. * M_PI), b = frand(20., 50.);
+      q[i][0] = 10. + b * cos(a);
+      q[i][1] =  5. + b * sin(a);
+      q[i][2] = frand(0., 6.);
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < N; j++)
+        t[i][j] += frand(-1., 1.) * 1e-9;
+    }
+
+    if (rfpos_grid_build(fname, D, N, m, lo, hi, 1.) < 0 ||
+        rfpos_grid_open(&grid, fname, D, N, m) < 0)
+    {
+      fprintf(stderr, "\nrfpos_grid: can't build '%s'\n", fname);
+      unlink(fname);
+      return 1;
+    }
+
+    it1 = 0;
+    t1 = get_time();
+    for (i = 0; i < kg; i++)
+      it1 += rfpos_calc_sub(&rfpos, (const rfpos_sub_t*) 0, 30, 1e-4, D, n,
+                            m, idx, t[i], (const double*) 0,
+                            (const double*) 0, &t0, r1[i]);
+    t1 = get_time() - t1;
+
+    it2 = 0;
+    t2 = get_time();
+    for (i = 0; i < kg; i++)
+      it2 += rfpos_calc_grid(&rfpos, &grid, 30, 1e-4, n, idx, t[i],
+                             &t0, r2[i]);
+    t2 = get_time() - t2;
+
+    rfpos_grid_close(&grid);
+    unlink(fname);
+
+    for (i = 0; i < kg; i++)
+    {
+      double s1 = 0., s2 = 0.;
+      rfpos_calc_sub(&rfpos, (const rfpos_sub_t*) 0, 30, 1e-4, D, n, m, idx,
+                     t[i], (const double*) 0, q[i], &t0, rr);
+      for (j = 0; j < D; j++)
+      {
+        s1 += (r1[i][j] - rr[j]) * (r1[i][j] - rr[j]);
+        s2 += (r2[i][j] - rr[j]) * (r2[i][j] - rr[j]);
+      }
+      if (sqrt(s1) > 0.01) w1++;
+      if (sqrt(s2) > 0.01) w2++;
+    }
+
+    fprintf(stderr, "\nrfpos_grid: %i of %i receivers, "
+            "transmitters 20...50 m outside, grid step 1 m\n", n, N);
+    fprintf(stderr, "rfpos_calc_sub(NULL): %8.1f ns/solve (wrong %i of %i)\n",
+            t1 * 1e9 / kg, w1, kg);
+    fprintf(stderr, "rfpos_calc_grid():    %8.1f ns/solve (wrong %i of %i)\n",
+            t2 * 1e9 / kg, w2, kg);
+  }
+
+  // смешанная точность: NF приёмников на площадке 200x200 м в абсолютных
+  // координатах (порядка 10^6 м), шум временных меток до 0.1 нс
+  {
+    static double mf[NF * D], tf[K / 10][NF];
+    static float ml[NF * D], tl[K / 10][NF];
+    static double tb[K / 10], bt0[K / 10], br[K / 10][D];
+    static int bn[K / 10], bidx[K / 10][NF], bst[K / 10];
+    const double o[D] = {4.5e5, 6.2e6, 150.};
+    const double pf[D] = {4.5e5 + 100., 6.2e6 + 100., 150.};
+    const int kf = K / 10;
+    rfpos_t rf;
+    rfpos_batch_f_t b = {kf, bn, bidx[0], tb, tl[0], (const float*) 0,
+                         (const float*) 0, bt0, br[0], bst};
+
+    for (i = 0; i < NF; i++)
+    {
+      mf[i * D]     = o[0] + frand(0., 200.);
+      mf[i * D + 1] = o[1] + frand(0., 200.);
+      mf[i * D + 2] = o[2] + frand(0., 20.);
+      for (j = 0; j < D; j++)
+        ml[i * D + j] = (float) (mf[i * D + j] - o[j]);
+    }
+    for (i = 0; i < kf; i++)
+    {
+      q[i][0] = o[0] + frand(0., 200.);
+      q[i][1] = o[1] + frand(0., 200.);
+      q[i][2] = o[2] + frand(0., 20.);
+      rfpos_test(D, NF, mf, q[i], 1e3 + 1e-3 * i, tf[i]);
+      tb[i] = tf[i][0];
+      bn[i] = NF;
+      for (j = 0; j < NF; j++)
+      {
+        tf[i][j] += frand(-1., 1.) * 1e-10;
+        tl[i][j] = (float) (tf[i][j] - tb[i]);
+        bidx[i][j] = j;
+      }
+    }
+
+    rfpos_init(&rf, D, NF);
+
+    it1 = 0;
+    t1 = get_time();
+    for (i = 0; i < kf; i++)
+      it1 += rfpos_calc(&rf, 30, 1e-4, D, NF, mf, tf[i], pf, &t0, r1[i]);
+    t1 = get_time() - t1;
+
+    rf.opt = RFPOS_OPT_F32;
+    it2 = 0;
+    t2 = get_time();
+    for (i = 0; i < kf; i++)
+      it2 += rfpos_calc(&rf, 30, 1e-4, D, NF, mf, tf[i], pf, &t0, r2[i]);
+    t2 = get_time() - t2;
+    rf.opt = RFPOS_OPT_NONE;
+
+    err = 0.;
+    for (i = 0; i < kf; i++)
+      for (j = 0; j < D; j++)
+        if (err < fabs(r1[i][j] - r2[i][j]))
+          err = fabs(r1[i][j] - r2[i][j]);
+
+    fprintf(stderr, "\nRFPOS_OPT_F32: n=%i, simd=%s\n", NF,
+            rfpos_simd_name(rf.simd));
+    fprintf(stderr, "rfpos_calc() double: %8.1f ns/solve (%.2f iterations/solve)\n",
+            t1 * 1e9 / kf, (double) it1 / kf);
+    fprintf(stderr, "rfpos_calc() F32:    %8.1f ns/solve (%.2f iterations/solve, "
+            "max |r1 - r2| = %g m)\n", t2 * 1e9 / kf, (double) it2 / kf, err);
+
+    // метод хорд: после сходимости шагов Гаусса-Ньютона проход по NF
+    // приёмникам вычисляет только W^(T) * F
+    rf.opt = RFPOS_OPT_CHORD;
+    it2 = nc = 0;
+    t2 = get_time();
+    for (i = 0; i < kf; i++)
+    {
+      it2 += rfpos_calc(&rf, 30, 1e-4, D, NF, mf, tf[i], pf, &t0, r2[i]);
+      nc += rf.nc;
+    }
+    t2 = get_time() - t2;
+    rf.opt = RFPOS_OPT_NONE;
+
+    err = 0.;
+    for (i = 0; i < kf; i++)
+      for (j = 0; j < D; j++)
+        if (err < fabs(r1[i][j] - r2[i][j]))
+          err = fabs(r1[i][j] - r2[i][j]);
+    fprintf(stderr, "rfpos_calc() CHORD:  %8.1f ns/solve (%.2f iterations/solve, "
+            "max |r1 - r2| = %g m)\n", t2 * 1e9 / kf, (double) it2 / kf, err);
+    fprintf(stderr, "rfpos_calc() CHORD:  %.2f passes/solve without normal matrix\n",
+            (double) nc / kf);
+
+    t2 = get_time();
+    rfpos_calc_batch_f(&rf, 30, 1e-4, D, o, ml, &b);
+    t2 = get_time() - t2;
+
+    err = 0.;
+    for (i = 0; i < kf; i++)
+      for (j = 0; j < D; j++)
+        if (err < fabs(r1[i][j] - br[i][j]))
+          err = fabs(r1[i][j] - br[i][j]);
+    fprintf(stderr, "rfpos_calc_batch_f(): %7.1f ns/solve "
+            "(p = NULL, max |r1 - r2| = %g m, %i of %i bytes/receiver)\n",
+            t2 * 1e9 / kf, err, (int) (D * sizeof(float)),
+            (int) (D * sizeof(double)));
+
+    rfpos_free(&rf);
+  }
+
+  // ассоциация: импульсы передатчиков внутри помещения через 1 мкс без
+  // номеров, обнаружения доставляются с задержкой 0...2 мкс (потоки
+  // приёмников перемешаны, импульсы перекрываются), допустимое опоздание
+  // 3 мкс; импульс ошибочный, если в нём не все N приёмников или метки
+  // разных импульсов
+  {
+    rfpos_assoc_t as;
+    int aidx[N], k, groups = 0, wrong = 0;
+    double at[N];
+
+    for (i = 0; i < K; i++)
+    {
+      q[i][0] = frand(-5., 25.);
+      q[i][1] = frand(-5., 25.);
+      q[i][2] = frand( 0.,  6.);
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < N; j++)
+      {
+        det_t *e = det + i * N + j;
+        e->t = t[i][j];
+        e->a = t[i][j] + frand(0., 2e-6);
+        e->i = j;
+      }
+    }
+    qsort(det, K * N, sizeof(det_t), det_cmp);
+
+    rfpos_assoc_init(&as, D, N, m, 8, 3e-6, 1e-9, D + 1);
+    t1 = get_time();
+    for (i = 0; i <= K * N; i++)
+    {
+      if (i < K * N)
+        rfpos_assoc_push(&as, det[i].i, det[i].t);
+      else
+        rfpos_assoc_flush(&as);
+      while ((k = rfpos_assoc_pop(&as, aidx, at)) > 0)
+      {
+        groups++;
+        if (k != N || (int) (at[0] * 1e6) != (int) (at[k - 1] * 1e6))
+          wrong++;
+      }
+    }
+    t1 = get_time() - t1;
+
+    fprintf(stderr, "\nrfpos_assoc: %i pulses, %i receivers, "
+            "delivery jitter 2 us\n", K, N);
+    fprintf(stderr, "push + pop: %8.1f ns/detection (pulses %i, wrong %i, "
+            "late %li)\n", t1 * 1e9 / (K * N), groups, wrong, as.late);
+    rfpos_assoc_free(&as);
+  }
+
+  // срок решения: исходная точка на удалении до 300 м от передатчика
+  // (часть импульсов требует многих итераций), задержка каждого решения;
+  // хвост распределения (p99.9) без срока и с бюджетом времени
+  {
+    static double lat[K], pf[K][D];
+    double bud[2] = {0., 3e-6}, ts, e1, ee;
+    int late, st, l;
+
+    for (i = 0; i < K; i++)
+    {
+      q[i][0] = frand(-5., 25.);
+      q[i][1] = frand(-5., 25.);
+      q[i][2] = frand( 0.,  6.);
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < D; j++)
+        pf[i][j] = q[i][j] + frand(-300., 300.);
+    }
+
+    fprintf(stderr, "\nrfpos_t::tdl: p = q +/- 300 m\n");
+    for (l = 0; l < 2; l++)
+    {
+      late = 0;
+      ee = 0.;
+      for (i = 0; i < K; i++)
+      {
+        ts = get_time();
+        rfpos.tdl = bud[l] > 0. ? ts + bud[l] : 0.;
+        st = rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], pf[i], &t0, r1[i]);
+        lat[i] = get_time() - ts;
+        if (st == RFPOS_ERR_TIME)
+        {
+          late++;
+          for (j = 0, e1 = 0.; j < D; j++)
+            e1 += (r1[i][j] - q[i][j]) * (r1[i][j] - q[i][j]);
+          ee += sqrt(e1);
+        }
+      }
+      rfpos.tdl = 0.;
+      std::sort(lat, lat + K);
+      fprintf(stderr, "budget %4.1f us: p50 %6.2f us p99.9 %6.2f us max %6.2f us"
+              " (timed out %i, mean error %g m)\n", bud[l] * 1e6,
+              lat[K / 2] * 1e6, lat[K - K / 1000] * 1e6, lat[K - 1] * 1e6,
+              late, late ? ee / late : 0.);
+    }
+  }
+
+  // разности дальностей (RFPOS_OPT_TDOA): d0 исключается, система 3x3
+  // вместо 4x4; шум временных меток до 0.1 нс (3 см), исходная точка -
+  // линеаризованное решение или p; решение ошибочное, если оно дальше
+  // 0.5 м от истинной точки
+  {
+    int l, k, bad[2][2], it[2][2];
+    double tt[2][2], e1;
+
+    for (i = 0; i < K; i++)
+    {
+      q[i][0] = frand(-5., 25.);
+      q[i][1] = frand(-5., 25.);
+      q[i][2] = frand( 0.,  6.);
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < N; j++)
+        t[i][j] += frand(-1., 1.) * 1e-10;
+    }
+
+    for (l = 0; l < 2; l++) // 0 - 4x4, 1 - RFPOS_OPT_TDOA
+      for (k = 0; k < 2; k++) // 0 - p = NULL, 1 - p
+      {
+        rfpos.opt = l ? RFPOS_OPT_TDOA : RFPOS_OPT_NONE;
+        it[l][k] = bad[l][k] = 0;
+        tt[l][k] = get_time();
+        for (i = 0; i < K; i++)
+          it[l][k] += rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i],
+                                 k ? p : (const double*) 0, &t0, r1[i]);
+        tt[l][k] = get_time() - tt[l][k];
+        for (i = 0; i < K; i++)
+        {
+          for (j = 0, e1 = 0.; j < D; j++)
+            e1 += (r1[i][j] - q[i][j]) * (r1[i][j] - q[i][j]);
+          if (!(e1 <= 0.25)) bad[l][k]++;
+        }
+      }
+    rfpos.opt = RFPOS_OPT_NONE;
+
+    fprintf(stderr, "\nRFPOS_OPT_TDOA: noise 0.1 ns\n");
+    for (l = 0; l < 2; l++)
+      for (k = 0; k < 2; k++)
+        fprintf(stderr, "%-14s p=%-4s %8.1f ns/solve (iterations: %i, "
+                "wrong: %i)\n", l ? "RFPOS_OPT_TDOA" : "4x4 (d0)",
+                k ? "p" : "NULL", tt[l][k] * 1e9 / K, it[l][k], bad[l][k]);
+  }
+
+  // опоздавшее обнаружение: импульс решён по N - 1 приёмникам, последний
+  // добавляется rfpos_calc_add() (ранг 1 и одна итерация) или полным
+  // повторным решением по N приёмникам; шум временных меток до 0.1 нс
+  {
+    static double lat[K]; // |dr| решений
+    double ta = 0., tf = 0., ts, e1;
+    int bad = 0;
+
+    for (i = 0; i < K; i++)
+    {
+      q[i][0] = frand(-5., 25.);
+      q[i][1] = frand(-5., 25.);
+      q[i][2] = frand( 0.,  6.);
+      rfpos_test(D, N, m, q[i], 1e-6 * i, t[i]);
+      for (j = 0; j < N; j++)
+        t[i][j] += frand(-1., 1.) * 1e-10;
+    }
+
+    for (i = 0; i < K; i++)
+    {
+      rfpos_calc(&rfpos, 30, 1e-4, D, N - 1, m, t[i], (const double*) 0,
+                 &t0, r2[i]);
+      ts = get_time();
+      if (rfpos_calc_add(&rfpos, m + (N - 1) * D, t[i][N - 1], 0., &t0,
+                         r2[i]) < 0)
+        bad++;
+      ta += get_time() - ts;
+
+      ts = get_time();
+      rfpos_calc(&rfpos, 30, 1e-4, D, N, m, t[i], (const double*) 0,
+                 &t0, r1[i]);
+      tf += get_time() - ts;
+
+      for (j = 0, e1 = 0.; j < D; j++)
+        e1 += (r1[i][j] - r2[i][j]) * (r1[i][j] - r2[i][j]);
+      lat[i] = sqrt(e1);
+    }
+    std::sort(lat, lat + K);
+
+    fprintf(stderr, "\nrfpos_calc_add(): late detection, n = %i -> %i\n",
+            N - 1, N);
+    fprintf(stderr, "rank-1 update + 1 iteration: %8.1f ns (errors %i)\n"
+            "full re-solve:               %8.1f ns\n"
+            "|dr| p50 %g m, p99 %g m, max %g m\n",
+            ta * 1e9 / K, bad, tf * 1e9 / K, lat[K / 2], lat[K - K / 100],
+            lat[K - 1]);
+  }
+
+  rfpos_free(&rfpos);
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_bench.cpp" ***/
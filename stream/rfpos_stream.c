@@ -0,0 +1,725 @@
+﻿/*
+ * Вычисление координат передатчика по задержкам сигнала до приёмников
+ * (потоковая обработка записей обнаружения: файл/stdin -> координаты)
+ * Version: 0.1b
+ * File: "rfpos_stream.c"
+ * Coding: UTF8
+ * (C) 2018 Alex Zorg <azorg@mail.ru>
+ * Licensed by GNU General Public License version 2
+ */
+
+//----------------------------------------------------------------------------
+#include <stdio.h>  // fopen(), fgets(), fread(), fprintf()
+#include <stdlib.h> // strtol(), strtod(), qsort(), bsearch()
+#include <string.h> // strcmp()
+#include <stdint.h> // int64_t, int32_t
+#include <math.h>   // sqrt(), NAN
+#include <time.h>   // clock_gettime()
+#include <unistd.h> // getopt()
+#include "rfpos.h"  // rfpos_calc_batch()
+#include "rfpos_site.h" // rfpos_calc_site()
+#include "rfpos_grid.h" // rfpos_grid_guess(), rfpos_calc_grid()
+#include "rfpos_assoc.h" // rfpos_assoc_push(), rfpos_assoc_pop()
+//----------------------------------------------------------------------------
+#define STREAM_K   1024 // число импульсов в пакете по умолчанию
+#define STREAM_BUF 4096 // максимальная длина строки текстовых файлов
+#define STREAM_IO  (1 << 20) // размер буферов ввода/вывода
+#define STREAM_CAP 64   // ёмкость буфера приёмника ассоциатора
+//----------------------------------------------------------------------------
+// двоичная запись обнаружения (24 байта, порядок байт машины)
+typedef struct {
+  int64_t pid;      // номер импульса
+  int32_t rid;      // номер приёмника (как в файле расположения)
+  int32_t reserved; // не используется (0)
+  double t;         // временная метка приёма сигнала [с]
+} stream_rec_t;
+//----------------------------------------------------------------------------
+// двоичная запись результата (56 байт, порядок байт машины)
+typedef struct {
+  int64_t pid;   // номер импульса
+  int32_t n;     // число приёмников
+  int32_t st;    // код возврата rfpos_calc() (число итераций или ошибка)
+  double r[3];   // координаты передатчика [м] (z=0 при d=2)
+  double t0;     // время излучения сигнала [с]
+  double rms;    // СКО невязки дальностей [м]
+} stream_out_t;
+//----------------------------------------------------------------------------
+// приёмник из файла расположения
+typedef struct {
+  long id;                // номер приёмника
+  double s[RFPOS_D_MAX];  // координаты приёмника [м]
+} stream_rx_t;
+//----------------------------------------------------------------------------
+// состояние потоковой обработки
+typedef struct {
+  // параметры
+  int d;        // размерность координат (2 или 3)
+  int it;       // максимальное число итераций
+  double e;     // желаемая точность [м]
+  int k;        // число импульсов в пакете
+  int bin_in;   // 1 - двоичный вход
+  int bin_out;  // 1 - двоичный выход
+  int opt;      // опции решателя RFPOS_OPT_*
+  int cache;    // размер кэша подмножеств приёмников (0 - без кэша)
+  const char *grid_name; // файл сетки исходных точек или NULL
+  double lag;   // допустимое опоздание обнаружений [с] (< 0 - без ассоциации)
+  double tol;   // допуск ассоциации на ошибку временных меток [с]
+  FILE *out;    // выходной поток
+
+  // таблица приёмников (отсортирована по номеру)
+  int nrx;          // число приёмников
+  stream_rx_t *rx;  // приёмники [nrx]
+  double *m;        // матрица координат приёмников [nrx][d]
+  long long *mark;  // номер импульса, в который уже вошёл приёмник [nrx]
+
+  // текущий пакет (память фиксирована: k импульсов по nrx приёмников)
+  int cnt;          // число закрытых импульсов в пакете
+  int used;         // число записей в пакете
+  int64_t *pid;     // номера импульсов [k]
+  int *n;           // число приёмников импульсов [k]
+  int *idx;         // индексы приёмников [k * nrx]
+  double *t;        // временные метки [k * nrx]
+  double *t0;       // оценки времени излучения [k]
+  double *r;        // координаты передатчиков [k][d]
+  int *st;          // коды возврата [k]
+
+  rfpos_t rfpos;      // рабочее пространство решателя
+  rfpos_site_t site;  // кэш подмножеств приёмников (при cache > 0)
+  rfpos_grid_t grid;  // сетка исходных точек (при grid_name != NULL)
+  rfpos_assoc_t assoc; // ассоциатор обнаружений (при lag >= 0)
+
+  // статистика
+  long long records; // число прочитанных записей
+  long long pulses;  // число импульсов
+  long long solved;  // число решённых импульсов
+  long long iters;   // суммарное число итераций
+  long long unknown; // записи с неизвестным номером приёмника
+  long long dup;     // повторные записи приёмника в одном импульсе
+  long long bad;     // нераспознанные строки текстового входа
+  long long late;    // опоздавшие или не вошедшие в буфер обнаружения
+} stream_t;
+//----------------------------------------------------------------------------
+// монотонное время [с]
+static double get_time()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return ((double) tv.tv_sec) + ((double) tv.tv_nsec) * 1e-9;
+}
+//----------------------------------------------------------------------------
+// пропустить разделители полей (пробелы, табуляции, запятые, точки с запятой)
+static char *skip_sep(char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == ',' || *p == ';')
+    p++;
+  return p;
+}
+//----------------------------------------------------------------------------
+// сравнение приёмников по номеру (для qsort() и bsearch())
+static int rx_cmp(const void *a, const void *b)
+{
+  long ia = ((const stream_rx_t*) a)->id;
+  long ib = ((const stream_rx_t*) b)->id;
+  return ia < ib ? -1 : ia > ib;
+}
+//----------------------------------------------------------------------------
+// загрузить файл расположения приёмников: строки "id x y [z]"
+// (в случае ошибки возвращается отрицательный код ошибки)
+static int rx_load(stream_t *self, const char *fname)
+{
+  FILE *f;
+  char buf[STREAM_BUF], *p, *e;
+  int i, j, cap = 64, line = 0;
+
+  f = fopen(fname, "r");
+  if (!f)
+  {
+    fprintf(stderr, "error: can't open layout file '%s'\n", fname);
+    return -1;
+  }
+
+  self->nrx = 0;
+  self->rx = (stream_rx_t*) malloc(sizeof(stream_rx_t) * cap);
+
+  while (self->rx && fgets(buf, sizeof(buf), f))
+  {
+    stream_rx_t rx;
+    line++;
+
+    p = skip_sep(buf);
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+      continue; // комментарий или пустая строка
+
+    rx.id = strtol(p, &e, 10);
+    for (j = 0; j < self->d && e != p; j++)
+    {
+      p = skip_sep(e);
+      rx.s[j] = strtod(p, &e);
+    }
+    if (e == p)
+    {
+      fprintf(stderr, "error: bad line %i in layout file '%s'\n", line, fname);
+      fclose(f);
+      return -2;
+    }
+
+    if (self->nrx == cap)
+    {
+      cap *= 2;
+      self->rx = (stream_rx_t*) realloc(self->rx, sizeof(stream_rx_t) * cap);
+      if (!self->rx) break;
+    }
+    self->rx[self->nrx++] = rx;
+  }
+  fclose(f);
+
+  if (!self->rx)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return -3;
+  }
+  if (self->nrx <= self->d)
+  {
+    fprintf(stderr, "error: layout file '%s' has %i receivers (need > %i)\n",
+            fname, self->nrx, self->d);
+    return -4;
+  }
+
+  qsort(self->rx, self->nrx, sizeof(stream_rx_t), rx_cmp);
+  for (i = 1; i < self->nrx; i++)
+    if (self->rx[i].id == self->rx[i - 1].id)
+    {
+      fprintf(stderr, "error: duplicate receiver id %li in '%s'\n",
+              self->rx[i].id, fname);
+      return -5;
+    }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// найти индекс приёмника по номеру (или -1)
+static int rx_find(const stream_t *self, long id)
+{
+  stream_rx_t key, *rx;
+  key.id = id;
+  rx = (stream_rx_t*) bsearch(&key, self->rx, self->nrx,
+                              sizeof(stream_rx_t), rx_cmp);
+  return rx ? (int) (rx - self->rx) : -1;
+}
+//----------------------------------------------------------------------------
+// прочитать следующую запись обнаружения
+// (возвращается 1 - запись прочитана, 0 - конец входа)
+static int rec_read(stream_t *self, FILE *f, stream_rec_t *rec)
+{
+  char buf[STREAM_BUF], *p, *e;
+
+  if (self->bin_in)
+    return fread(rec, sizeof(stream_rec_t), 1, f) == 1;
+
+  while (fgets(buf, sizeof(buf), f))
+  {
+    p = skip_sep(buf);
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+      continue; // комментарий или пустая строка
+
+    rec->pid = 0;
+    e = (char*) 0;
+    if (self->lag < 0.)
+    {
+      rec->pid = strtoll(p, &e, 10);
+      if (e != p) p = skip_sep(e);
+    }
+    if (e != p)
+      rec->rid = (int32_t) strtol(p, &e, 10);
+    if (e != p)
+    {
+      p = skip_sep(e);
+      rec->t = strtod(p, &e);
+    }
+    if (e != p)
+      return 1;
+
+    self->bad++; // например, строка заголовка
+  }
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+// СКО невязки дальностей импульса [м]: |R - S[i]| - C * (t[i] - t0)
+static double pulse_rms(
+  const stream_t *self, int n, const int *idx, const double *t,
+  double t0, const double *r)
+{
+  int i, j, d = self->d;
+  double s = 0.;
+
+  for (i = 0; i < n; i++)
+  {
+    const double *m = self->m + idx[i] * d;
+    double q, dd = 0.;
+    for (j = 0; j < d; j++)
+    {
+      q = r[j] - m[j];
+      dd += q * q;
+    }
+    q = sqrt(dd) - (t[i] - t0) * RFPOS_C;
+    s += q * q;
+  }
+
+  return sqrt(s / (double) n);
+}
+//----------------------------------------------------------------------------
+// решить накопленный пакет и вывести результаты
+static void stream_flush(stream_t *self)
+{
+  rfpos_batch_t b;
+  int k, j, d = self->d, off = 0;
+
+  if (!self->cnt)
+    return;
+
+  b.k   = self->cnt;
+  b.n   = self->n;
+  b.idx = self->idx;
+  b.t   = self->t;
+  b.s   = (const double*) 0;
+  b.p   = (const double*) 0;
+  b.t0  = self->t0;
+  b.r   = self->r;
+  b.st  = self->st;
+  b.cov = (rfpos_cov_t*) 0;
+  b.tdl = (const double*) 0;
+  b.ord = (int*) 0;
+  if (self->cache > 0 || self->grid_name)
+  { // импульсы по одному с данными подмножеств из кэша и/или с исходной
+    // точкой холодного старта из сетки (если узел не найден - без исходной
+    // точки, как в rfpos_calc_grid())
+    for (k = 0; k < self->cnt; k++)
+    {
+      double p[RFPOS_D_MAX];
+      int st;
+      if (self->cache <= 0)
+        st = rfpos_calc_grid(&self->rfpos, &self->grid, self->it, self->e,
+                             self->n[k], self->idx + off, self->t + off,
+                             &self->t0[k], &self->r[k * d]);
+      else
+        st = rfpos_calc_site(&self->rfpos, &self->site, self->it, self->e,
+                             self->n[k], self->idx + off, self->t + off,
+                             (const double*) 0, self->grid_name &&
+                             rfpos_grid_guess(&self->grid, self->n[k],
+                                              self->idx + off, self->t + off,
+                                              p) == 0 ? p : (const double*) 0,
+                             &self->t0[k], &self->r[k * d]);
+      self->st[k] = st;
+      if (st >= 0) self->solved++;
+      off += self->n[k];
+    }
+    off = 0;
+  }
+  else
+    self->solved += rfpos_calc_batch(&self->rfpos, self->it, self->e, d,
+                                     self->m, &b);
+
+  for (k = 0; k < self->cnt; k++)
+  {
+    int n = self->n[k], st = self->st[k];
+    const double *r = self->r + k * d;
+    double rms = NAN;
+
+    if (st >= 0)
+    {
+      self->iters += st;
+      rms = pulse_rms(self, n, self->idx + off, self->t + off,
+                      self->t0[k], r);
+    }
+
+    if (self->bin_out)
+    {
+      stream_out_t o;
+      o.pid = self->pid[k];
+      o.n   = n;
+      o.st  = st;
+      o.r[2] = 0.;
+      for (j = 0; j < d; j++)
+        o.r[j] = st >= 0 ? r[j] : NAN;
+      o.t0  = st >= 0 ? self->t0[k] : NAN;
+      o.rms = rms;
+      fwrite(&o, sizeof(o), 1, self->out);
+    }
+    else if (st >= 0)
+    {
+      fprintf(self->out, "%lli,%i,%i", (long long) self->pid[k], n, st);
+      for (j = 0; j < d; j++)
+        fprintf(self->out, ",%.4f", r[j]);
+      fprintf(self->out, ",%.9f,%.4g\n", self->t0[k], rms);
+    }
+    else
+    {
+      fprintf(self->out, "%lli,%i,%i", (long long) self->pid[k], n, st);
+      for (j = 0; j < d; j++)
+        fprintf(self->out, ",nan");
+      fprintf(self->out, ",nan,nan\n");
+    }
+
+    off += n;
+  }
+
+  self->cnt  = 0;
+  self->used = 0;
+}
+//----------------------------------------------------------------------------
+// выделить память пакета и рабочего пространства
+// (в случае ошибки возвращается отрицательный код ошибки)
+static int stream_init(stream_t *self)
+{
+  int i, j, k = self->k, n = self->nrx, d = self->d;
+
+  self->m    = (double*) malloc(sizeof(double) * n * d);
+  self->mark = (long long*) malloc(sizeof(long long) * n);
+  self->pid  = (int64_t*) malloc(sizeof(int64_t) * k);
+  self->n    = (int*)    malloc(sizeof(int) * k);
+  self->idx  = (int*)    malloc(sizeof(int) * k * n);
+  self->t    = (double*) malloc(sizeof(double) * k * n);
+  self->t0   = (double*) malloc(sizeof(double) * k);
+  self->r    = (double*) malloc(sizeof(double) * k * d);
+  self->st   = (int*)    malloc(sizeof(int) * k);
+
+  if (!self->m || !self->mark || !self->pid || !self->n || !self->idx ||
+      !self->t || !self->t0 || !self->r || !self->st)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return -1;
+  }
+
+  for (i = 0; i < n; i++)
+  {
+    for (j = 0; j < d; j++)
+      self->m[i * d + j] = self->rx[i].s[j];
+    self->mark[i] = -1;
+  }
+
+  self->cnt = self->used = 0;
+  self->records = self->pulses = self->solved = self->iters = 0;
+  self->unknown = self->dup = self->bad = self->late = 0;
+
+  rfpos_init(&self->rfpos, d, n);
+  self->rfpos.opt = self->opt;
+
+  if (self->cache > 0 &&
+      rfpos_site_init(&self->site, d, n, self->m, self->cache) < 0)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return -1;
+  }
+
+  if (self->grid_name)
+  {
+    int retv = rfpos_grid_open(&self->grid, self->grid_name, d, n, self->m);
+    if (retv < 0)
+    {
+      fprintf(stderr, "error: can't use grid file '%s' (%s)\n",
+              self->grid_name, retv == RFPOS_GRID_ERR_LAYOUT ?
+              "built for another layout" : retv == RFPOS_GRID_ERR_FORMAT ?
+              "bad format or version" : "can't map file");
+      return -1;
+    }
+  }
+
+  if (self->lag >= 0. &&
+      rfpos_assoc_init(&self->assoc, d, n, self->m, STREAM_CAP, self->lag,
+                       self->tol, d + 1) < 0)
+  {
+    fprintf(stderr, "error: out of memory\n");
+    return -1;
+  }
+  return 0;
+}
+//----------------------------------------------------------------------------
+// освободить память
+static void stream_free(stream_t *self)
+{
+  if (self->lag >= 0.)
+    rfpos_assoc_free(&self->assoc);
+  if (self->grid_name)
+    rfpos_grid_close(&self->grid);
+  if (self->cache > 0)
+    rfpos_site_free(&self->site);
+  rfpos_free(&self->rfpos);
+  free(self->st);
+  free(self->r);
+  free(self->t0);
+  free(self->t);
+  free(self->idx);
+  free(self->n);
+  free(self->pid);
+  free(self->mark);
+  free(self->m);
+  free(self->rx);
+}
+//----------------------------------------------------------------------------
+// обработать входной поток: записи с одинаковым номером импульса, идущие
+// подряд, образуют импульс; импульсы накапливаются в пакеты по k штук
+static void stream_run(stream_t *self, FILE *in)
+{
+  stream_rec_t rec;
+  int64_t cur = 0;
+  int open = 0; // 1 - текущий импульс открыт
+
+  while (rec_read(self, in, &rec))
+  {
+    int i, ix;
+    self->records++;
+
+    if (open && rec.pid != cur)
+    { // закрыть текущий импульс
+      self->used += self->n[self->cnt];
+      if (++self->cnt == self->k)
+        stream_flush(self);
+      open = 0;
+    }
+
+    if (!open)
+    { // открыть новый импульс
+      cur = rec.pid;
+      self->pid[self->cnt] = cur;
+      self->n[self->cnt] = 0;
+      self->pulses++;
+      open = 1;
+    }
+
+    ix = rx_find(self, rec.rid);
+    if (ix < 0)
+    {
+      self->unknown++;
+      continue;
+    }
+    if (self->mark[ix] == self->pulses)
+    {
+      self->dup++; // остаётся первая запись приёмника
+      continue;
+    }
+    self->mark[ix] = self->pulses;
+
+    i = self->used + self->n[self->cnt]++;
+    self->idx[i] = ix;
+    self->t[i]   = rec.t;
+  }
+
+  if (open)
+  { // закрыть последний импульс
+    self->used += self->n[self->cnt];
+    self->cnt++;
+  }
+  stream_flush(self);
+}
+//----------------------------------------------------------------------------
+// забрать из ассоциатора закрытые импульсы в пакет (номера импульсов -
+// порядковые, с нуля)
+static void stream_pop(stream_t *self)
+{
+  int n;
+
+  while ((n = rfpos_assoc_pop(&self->assoc, self->idx + self->used,
+                              self->t + self->used)) > 0)
+  {
+    self->pid[self->cnt] = self->pulses++;
+    self->n[self->cnt] = n;
+    self->used += n;
+    if (++self->cnt == self->k)
+      stream_flush(self);
+  }
+}
+//----------------------------------------------------------------------------
+// обработать входной поток без номеров импульсов: независимые потоки
+// обнаружений приёмников объединяются в импульсы ассоциатором
+static void stream_run_assoc(stream_t *self, FILE *in)
+{
+  stream_rec_t rec;
+
+  while (rec_read(self, in, &rec))
+  {
+    int ix;
+    self->records++;
+
+    ix = rx_find(self, rec.rid);
+    if (ix < 0)
+    {
+      self->unknown++;
+      continue;
+    }
+
+    if (rfpos_assoc_push(&self->assoc, ix, rec.t) < 0)
+      self->late++;
+    else
+      stream_pop(self);
+  }
+
+  rfpos_assoc_flush(&self->assoc);
+  stream_pop(self);
+  stream_flush(self);
+}
+//----------------------------------------------------------------------------
+static void usage()
+{
+  fprintf(stderr,
+    "Usage: rfpos_stream [options] -l LAYOUT [INPUT]\n"
+    "Solve transmitter positions for a stream of detection records.\n"
+    "\n"
+    "  -l FILE  receiver layout: lines \"id x y [z]\" (meters)\n"
+    "  -d D     dimension 2 or 3 (default 3)\n"
+    "  -b       binary input: records {int64 pulse_id; int32 receiver_id;\n"
+    "           int32 reserved; double t} (24 bytes, native byte order)\n"
+    "  -B       binary output: records {int64 pulse_id; int32 n; int32 st;\n"
+    "           double r[3]; double t0; double rms} (56 bytes)\n"
+    "  -o FILE  output file (default stdout)\n"
+    "  -i IT    maximum number of iterations (default 30)\n"
+    "  -e E     accuracy [m] (default 1e-4)\n"
+    "  -k K     pulses per batch (default %i)\n"
+    "  -L       Levenberg-Marquardt iterations (default Gauss-Newton)\n"
+    "  -Q       solve Gauss-Newton steps by Householder QR instead of\n"
+    "           normal equations (better for poor geometry)\n"
+    "  -T       range-difference (TDOA) iterations: t0 is eliminated and\n"
+    "           only the position (d x d system) is iterated\n"
+    "  -C       reuse the normal-matrix factorization between iterations\n"
+    "           (chord steps with BFGS updates after the first iteration)\n"
+    "  -c N     cache per-subset data of N receiver subsets (default 0 -\n"
+    "           no cache; only the first %i receivers are cached)\n"
+    "  -g FILE  grid file from rfpos_mkgrid: cold-start initial points\n"
+    "           (pulses are solved one at a time; a pulse with no grid\n"
+    "           node starts from the linearized solution)\n"
+    "  -a LAG   input has no pulse ids: associate per-receiver detections\n"
+    "           into pulses, accepting detections up to LAG seconds late\n"
+    "  -t TOL   association timestamp tolerance [s] (default 1e-8)\n"
+    "  -q       do not print statistics to stderr\n"
+    "\n"
+    "Text input lines are \"pulse_id,receiver_id,timestamp\" (separators:\n"
+    "comma, semicolon, space or tab; '#' starts a comment). Consecutive\n"
+    "records with the same pulse_id form one pulse. Text output lines are\n"
+    "\"pulse_id,n,st,x,y[,z],t0,rms\", where st is the number of iterations\n"
+    "or a negative error code and rms is the range residual [m].\n"
+    "With -a text input lines are \"receiver_id,timestamp\" (binary\n"
+    "pulse_id is ignored) and output pulse_id is the pulse number.\n",
+    STREAM_K, RFPOS_SITE_MAX);
+}
+//----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+  stream_t s;
+  rfpos_stat_t st;
+  const char *layout = (const char*) 0, *oname = (const char*) 0;
+  FILE *in = stdin;
+  int c, quiet = 0;
+  double tm;
+
+  s.d = 3;
+  s.it = 30;
+  s.e = 1e-4;
+  s.k = STREAM_K;
+  s.bin_in = s.bin_out = 0;
+  s.opt = RFPOS_OPT_NONE;
+  s.cache = 0;
+  s.grid_name = (const char*) 0;
+  s.lag = -1.;
+  s.tol = 1e-8;
+  s.rx = (stream_rx_t*) 0;
+
+  while ((c = getopt(argc, argv, "l:d:bBo:i:e:k:LQTCc:g:a:t:qh")) != -1)
+  {
+    switch (c)
+    {
+      case 'l': layout = optarg;             break;
+      case 'd': s.d    = atoi(optarg);       break;
+      case 'b': s.bin_in  = 1;               break;
+      case 'B': s.bin_out = 1;               break;
+      case 'o': oname  = optarg;             break;
+      case 'i': s.it   = atoi(optarg);       break;
+      case 'e': s.e    = atof(optarg);       break;
+      case 'k': s.k    = atoi(optarg);       break;
+      case 'L': s.opt  = RFPOS_OPT_LM;       break;
+      case 'Q': s.opt  = RFPOS_OPT_QR;       break;
+      case 'T': s.opt  = RFPOS_OPT_TDOA;     break;
+      case 'C': s.opt  = RFPOS_OPT_CHORD;    break;
+      case 'c': s.cache = atoi(optarg);      break;
+      case 'g': s.grid_name = optarg;        break;
+      case 'a': s.lag  = atof(optarg);       break;
+      case 't': s.tol  = atof(optarg);       break;
+      case 'q': quiet  = 1;                  break;
+      default:  usage(); return c == 'h' ? 0 : 1;
+    }
+  }
+
+  if (!layout || s.d < 2 || s.d > RFPOS_D_MAX || s.k < 1 || s.it < 0 ||
+      s.tol < 0. || optind < argc - 1)
+  {
+    usage();
+    return 1;
+  }
+
+  if (rx_load(&s, layout) < 0)
+    return 1;
+
+  if (optind < argc && strcmp(argv[optind], "-") != 0)
+  {
+    in = fopen(argv[optind], s.bin_in ? "rb" : "r");
+    if (!in)
+    {
+      fprintf(stderr, "error: can't open input file '%s'\n", argv[optind]);
+      return 1;
+    }
+  }
+
+  s.out = oname ? fopen(oname, s.bin_out ? "wb" : "w") : stdout;
+  if (!s.out)
+  {
+    fprintf(stderr, "error: can't create output file '%s'\n", oname);
+    return 1;
+  }
+
+  setvbuf(in, (char*) 0, _IOFBF, STREAM_IO);
+  setvbuf(s.out, (char*) 0, _IOFBF, STREAM_IO);
+
+  if (stream_init(&s) < 0)
+    return 1;
+
+  tm = get_time();
+  if (s.lag >= 0.) stream_run_assoc(&s, in);
+  else             stream_run(&s, in);
+  tm = get_time() - tm;
+
+  if (!quiet)
+  {
+    fprintf(stderr,
+      "records: %lli, pulses: %lli, solved: %lli (%.2f iterations/pulse)\n",
+      s.records, s.pulses, s.solved,
+      s.solved ? (double) s.iters / (double) s.solved : 0.);
+    fprintf(stderr,
+      "unknown receivers: %lli, duplicates: %lli, bad lines: %lli\n",
+      s.unknown, s.dup, s.bad);
+    if (s.lag >= 0.)
+      fprintf(stderr, "association: late/overflow: %lli, dropped: %li\n",
+        s.late, s.assoc.drop);
+    if (s.cache > 0)
+      fprintf(stderr, "subset cache: hit: %li, miss: %li, evicted: %li\n",
+        s.site.hit, s.site.miss, s.site.evict);
+    if (rfpos_stat_get(&s.rfpos, &st) && st.solves)
+    { // сборка с RFPOS_STATS: время фаз итераций на одно решение
+      double k = 1. / (double) st.solves;
+      fprintf(stderr, "solver: %.0f ns/solve (residual and jacobian: %.0f, "
+        "residual only: %.0f, linear solve: %.0f ns/solve)\n",
+        (double) st.ns * k, (double) st.ph_ns[RFPOS_STAT_FW] * k,
+        (double) st.ph_ns[RFPOS_STAT_F] * k,
+        (double) st.ph_ns[RFPOS_STAT_LIN] * k);
+    }
+    fprintf(stderr, "time: %.3f s (%.0f pulses/min)\n",
+      tm, tm > 0. ? (double) s.pulses * 60. / tm : 0.);
+  }
+
+  if (in != stdin) fclose(in);
+  if (s.out != stdout) fclose(s.out);
+  stream_free(&s);
+
+  return 0;
+}
+//----------------------------------------------------------------------------
+
+/*** end of "rfpos_stream.c" ***/